@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "datagen.hpp"
+#include "skyline.hpp"
+
+/** Timings and counts of repeated runs of one algorithm with one set of parameters. */
+struct Measurement {
+    /** Running time of each run, in milliseconds. */
+    std::vector<double> runningTimes;
+    /** Comparison count of each run. */
+    std::vector<size_type> comparisonCounts;
+    /** Peak resident set size of the process during the runs, in kilobytes. */
+    long peakResidentSetSize;
+    /** Number of heap allocations of each run. */
+    std::vector<std::uint64_t> allocationCounts;
+};
+
+/** Number of heap allocations made by the process; counted by the replaced global operator new. */
+static std::atomic<std::uint64_t> allocationCount(0);
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size > 0 ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+/**
+ * Compute the skyline the specified number of times, timing every run.
+ * Every run uses its number as the seed, so noisy runs get different oracle errors,
+ * but the whole benchmark is reproducible.
+ * For the noisy algorithm, the number of oracle calls is used as the comparison count.
+ */
+Measurement measure(const Dataset& dataset, SkylineOptions options, size_type runs);
+
+/**
+ * Run all algorithms on the dataset, and write a CSV row for each of them.
+ * The noisy algorithm is run for every combination of tolerance and error probability.
+ */
+void benchmark(const Dataset& dataset, const std::string& type, size_type runs, std::ostream& csv);
+
+/**
+ * Write a CSV row with the measurement;
+ * running_time is the median running time, and comparison_count and allocations are means over the runs.
+ */
+void measurementWrite(std::ostream& csv, const char* algorithm, const std::string& type, const Dataset& dataset,
+        double tolerance, double errorProbability, const Measurement& measurement);
+
+/** Value at the specified fraction of the sorted values, using the nearest rank. */
+double percentile(const std::vector<double>& sorted, double fraction);
+
+/**
+ * Reset the peak resident set size of the process, so that the next call to peakResidentSetSize()
+ * reports only memory used after this call; does nothing if the kernel does not support it.
+ */
+void peakResidentSetSizeReset();
+
+/** Peak resident set size of the process, in kilobytes. */
+long peakResidentSetSize();
+
+/*
+ * Parameter grid; the same as CONFIG in experiments.py.
+ * Correlated datasets with one dimension are the same as independent ones, so they are skipped.
+ */
+static const char* const CORRELATION_TYPES[] = {"independent", "correlated"};
+static const size_type CARDINALITIES[] = {1000, 10000, 100000, 1000000};
+static const size_type DIMENSIONALITIES[] = {1, 2, 4, 8, 16};
+static const double TOLERANCES[] = {0.1, 0.2, 0.3, 0.4};
+static const double ERROR_PROBABILITIES[] = {0.001, 0.01, 0.1};
+
+/** Default number of runs of each algorithm with each set of parameters. */
+static const size_type NRUNS = 100;
+
+/** Main entry point. */
+int main(int argc, char** argv) {
+    if (argc != 2 && argc != 3 && argc != 4 && argc != 6) {
+        std::cerr << "Usage: " << argv[0] << " output [runs [max_cardinality]]" << std::endl;
+        std::cerr << "       " << argv[0] << " output runs input size dimensions" << std::endl;
+        std::cerr << "Without input, datasets are generated for the whole parameter grid"
+                << " (up to max_cardinality items)." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto output = argv[1];
+    auto runs = (argc >= 3) ? datasetSizeParse(argv[2]) : NRUNS;
+    auto maxCardinality = (argc == 4) ? datasetSizeParse(argv[3]) : std::numeric_limits<size_type>::max();
+
+    try {
+        if (runs == 0) {
+            throw std::runtime_error("Number of runs must be positive");
+        }
+        std::ofstream csv(output);
+        if (!csv) {
+            throw std::runtime_error(std::string("Cannot open file ") + output);
+        }
+        // Enough digits to write comparison counts without the exponent.
+        csv.precision(std::numeric_limits<double>::digits10);
+        csv << "algorithm,type,cardinality,dimensionality,tolerance,error_probability,running_time,comparson_count"
+                << ",running_time_min,running_time_p90,running_time_p99,running_time_max,runs,peak_rss,allocations" << std::endl;
+
+        if (argc == 6) {
+            auto dataset = datasetMap(argv[3], datasetSizeParse(argv[4]), datasetSizeParse(argv[5]), MapHint::populate);
+            benchmark(dataset, "file", runs, csv);
+            return EXIT_SUCCESS;
+        }
+
+        ThreadPool pool(0);
+        std::uint64_t seed = 0;
+        for (auto type : CORRELATION_TYPES) {
+            for (auto size : CARDINALITIES) {
+                if (size > maxCardinality) {
+                    continue;
+                }
+                for (auto ndims : DIMENSIONALITIES) {
+                    if (std::string(type) != "independent" && ndims == 1) {
+                        continue;
+                    }
+                    // The dataset is generated once, and shared by all algorithms and runs.
+                    Dataset dataset(size, ndims);
+                    datagenFill(dataset, distributionParse(type), seed++, pool);
+                    benchmark(dataset, type, runs, csv);
+                }
+            }
+        }
+        return EXIT_SUCCESS;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
+
+Measurement measure(const Dataset& dataset, SkylineOptions options, size_type runs) {
+    Measurement measurement;
+    Skyline skyline;
+    peakResidentSetSizeReset();
+    for (size_type run = 0; run < runs; run++) {
+        options.seed = run;
+        SkylineStats stats;
+        auto beforeAllocations = allocationCount.load();
+        auto beforeTime = std::chrono::steady_clock::now();
+        skylineCompute(dataset, options, skyline, stats);
+        auto afterTime = std::chrono::steady_clock::now();
+        measurement.allocationCounts.push_back(allocationCount.load() - beforeAllocations);
+        measurement.runningTimes.push_back(std::chrono::duration<double, std::milli>(afterTime - beforeTime).count());
+        measurement.comparisonCounts.push_back(
+                (options.algorithm == Algorithm::noisy) ? stats.oracleCalls : stats.comparisonCount);
+    }
+    measurement.peakResidentSetSize = peakResidentSetSize();
+    return measurement;
+}
+
+void benchmark(const Dataset& dataset, const std::string& type, size_type runs, std::ostream& csv) {
+    SkylineOptions options;
+    std::cerr << "nestedloops (type=" << type << ", n=" << dataset.size() << ", d=" << dataset.ndims() << ")" << std::endl;
+    options.algorithm = Algorithm::nestedloops;
+    measurementWrite(csv, "nestedloops", type, dataset, 0, 0, measure(dataset, options, runs));
+
+    std::cerr << "noisless (type=" << type << ", n=" << dataset.size() << ", d=" << dataset.ndims() << ")" << std::endl;
+    options.algorithm = Algorithm::noisless;
+    measurementWrite(csv, "noisless", type, dataset, 0, 0, measure(dataset, options, runs));
+
+    std::cerr << "bskytree (type=" << type << ", n=" << dataset.size() << ", d=" << dataset.ndims() << ")" << std::endl;
+    options.algorithm = Algorithm::bskytree;
+    measurementWrite(csv, "bskytree", type, dataset, 0, 0, measure(dataset, options, runs));
+
+    options.algorithm = Algorithm::noisy;
+    for (auto tolerance : TOLERANCES) {
+        for (auto errorProbability : ERROR_PROBABILITIES) {
+            std::cerr << "noisy (type=" << type << ", n=" << dataset.size() << ", d=" << dataset.ndims()
+                    << ", t=" << tolerance << ", p=" << errorProbability << ")" << std::endl;
+            options.tolerance = tolerance;
+            options.errorProbability = errorProbability;
+            measurementWrite(csv, "noisy", type, dataset, tolerance, errorProbability, measure(dataset, options, runs));
+        }
+    }
+}
+
+void measurementWrite(std::ostream& csv, const char* algorithm, const std::string& type, const Dataset& dataset,
+        double tolerance, double errorProbability, const Measurement& measurement) {
+    auto times = measurement.runningTimes;
+    std::sort(times.begin(), times.end());
+    double comparisonCount = 0;
+    for (auto count : measurement.comparisonCounts) {
+        comparisonCount += static_cast<double>(count);
+    }
+    comparisonCount /= static_cast<double>(measurement.comparisonCounts.size());
+    double allocations = 0;
+    for (auto count : measurement.allocationCounts) {
+        allocations += static_cast<double>(count);
+    }
+    allocations /= static_cast<double>(measurement.allocationCounts.size());
+
+    csv << algorithm << "," << type << "," << dataset.size() << "," << dataset.ndims() << ","
+            << tolerance << "," << errorProbability << "," << percentile(times, 0.5) << "," << comparisonCount << ","
+            << times.front() << "," << percentile(times, 0.9) << "," << percentile(times, 0.99) << "," << times.back() << ","
+            << times.size() << "," << measurement.peakResidentSetSize << "," << allocations << std::endl;
+}
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+    auto rank = static_cast<size_type>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::max<size_type>(rank, 1) - 1];
+}
+
+void peakResidentSetSizeReset() {
+    // Writing 5 to clear_refs resets the peak resident set size reported in /proc/self/status (Linux 4.0+).
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+}
+
+long peakResidentSetSize() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            long kilobytes = 0;
+            std::istringstream(line.substr(6)) >> kilobytes;
+            return kilobytes;
+        }
+    }
+    // The peak over the whole lifetime of the process, in kilobytes on Linux.
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
@@ -0,0 +1,201 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "bskytree.hpp"
+
+/**
+ * Region of an item relative to the pivot: bit k is set if the item is not less than the pivot on dimension k.
+ * Only the first REGION_DIMS dimensions are encoded; the rest are still compared by dominance tests.
+ */
+typedef std::uint64_t Region;
+
+static const size_type REGION_DIMS = std::numeric_limits<Region>::digits;
+
+/** Skylines of at most this number of items are computed with nested loops instead of partitioning further. */
+static const size_type BSKYTREE_LEAF = 32;
+
+/** Skyline of one region, with a contiguous copy of the values of its items. */
+template<typename T>
+struct RegionSkyline {
+    Region region;
+    size_type count;
+    std::vector<T> rows;
+};
+
+/**
+ * Pick a skyline item of the specified items as the pivot.
+ * The candidate maximizes its least value normalized by the range of each dimension,
+ * and is then replaced by any item that dominates it.
+ */
+template<typename T>
+static size_type pivotSelect(const BasicDataset<T>& dataset, const Skyline& items, size_type& comparisonCount);
+
+/** Append the skyline of the specified items to the skyline. */
+template<typename T>
+static void bskytreeItems(const BasicDataset<T>& dataset, const Skyline& items, Skyline& skyline,
+        size_type& comparisonCount);
+
+template<typename T>
+static size_type pivotSelect(const BasicDataset<T>& dataset, const Skyline& items, size_type& comparisonCount) {
+    auto ndims = dataset.ndims();
+    std::vector<T> low(&dataset(items.front(),0), &dataset(items.front(),0) + ndims);
+    std::vector<T> high(low);
+    for (auto i : items) {
+        for (size_type k = 0; k < ndims; k++) {
+            low[k] = std::min(low[k], dataset(i,k));
+            high[k] = std::max(high[k], dataset(i,k));
+        }
+    }
+    // Every item is compared with the low and the high end of the range on each dimension.
+    comparisonCount += 2 * ndims * items.size();
+
+    size_type pivot = items.front();
+    double best = -1;
+    for (auto i : items) {
+        double least = 1;
+        for (size_type k = 0; k < ndims; k++) {
+            if (low[k] < high[k]) {
+                least = std::min(least, (static_cast<double>(dataset(i,k)) - static_cast<double>(low[k]))
+                        / (static_cast<double>(high[k]) - static_cast<double>(low[k])));
+            }
+        }
+        if (least > best) {
+            best = least;
+            pivot = i;
+        }
+    }
+    // The normalized value of every item is compared with the least one so far on each dimension.
+    comparisonCount += ndims * items.size();
+
+    // A single pass is enough: an item that dominates the final pivot would dominate every earlier one.
+    auto dominated = dominatedByKernel<T>(ndims);
+    for (auto i : items) {
+        if (i != pivot && dominated(&dataset(pivot,0), &dataset(i,0), ndims, comparisonCount)) {
+            pivot = i;
+        }
+    }
+    return pivot;
+}
+
+template<typename T>
+static void bskytreeItems(const BasicDataset<T>& dataset, const Skyline& items, Skyline& skyline,
+        size_type& comparisonCount) {
+    if (items.empty()) {
+        return;
+    }
+    auto ndims = dataset.ndims();
+    auto dominated = dominatedByKernel<T>(ndims);
+    if (items.size() <= BSKYTREE_LEAF) {
+        for (auto i : items) {
+            bool isDominated = false;
+            for (auto j : items) {
+                if (j != i && dominated(&dataset(i,0), &dataset(j,0), ndims, comparisonCount)) {
+                    isDominated = true;
+                    break;
+                }
+            }
+            if (!isDominated) {
+                skyline.push_back(i);
+            }
+        }
+        return;
+    }
+
+    auto pivot = pivotSelect(dataset, items, comparisonCount);
+    const T* p = &dataset(pivot,0);
+    skyline.push_back(pivot);
+
+    // Items equal to the pivot are skyline items, and items dominated by it are dropped.
+    // No item is greater than the pivot on every dimension, since the pivot is a skyline item.
+    std::vector<std::pair<Region, size_type>> regions;
+    regions.reserve(items.size());
+    for (auto i : items) {
+        if (i == pivot) {
+            continue;
+        }
+        const T* a = &dataset(i,0);
+        Region region = 0;
+        size_type gt = 0, lt = 0;
+        for (size_type k = 0; k < ndims; k++) {
+            gt += a[k] > p[k];
+            lt += a[k] < p[k];
+            if (k < REGION_DIMS && !(a[k] < p[k])) {
+                region |= Region(1) << k;
+            }
+        }
+        // Both the "greater" and the "less" test are made on every dimension.
+        comparisonCount += 2 * ndims;
+        if (gt == 0 && lt == 0) {
+            skyline.push_back(i);
+        } else if (gt > 0) {
+            regions.emplace_back(region, i);
+        }
+    }
+
+    // Supersets have more bits set, so they come first.
+    std::sort(regions.begin(), regions.end(), [](const std::pair<Region, size_type>& a,
+            const std::pair<Region, size_type>& b) {
+        auto abits = __builtin_popcountll(a.first), bbits = __builtin_popcountll(b.first);
+        return (abits != bbits) ? abits > bbits : a < b;
+    });
+
+    std::vector<RegionSkyline<T>> done;
+    std::vector<const RegionSkyline<T>*> supersets;
+    Skyline group, local;
+    for (size_type first = 0; first < regions.size();) {
+        auto region = regions[first].first;
+        supersets.clear();
+        for (const auto& part : done) {
+            if ((region & ~part.region) == 0) {
+                supersets.push_back(&part);
+            }
+        }
+
+        // Items dominated by the skyline of a superset region are not in the skyline of their own region,
+        // and neither are the items they dominate, so they are dropped before the recursion.
+        group.clear();
+        for (; first < regions.size() && regions[first].first == region; first++) {
+            auto i = regions[first].second;
+            bool isDominated = false;
+            for (auto part : supersets) {
+                if (findDominator(&dataset(i,0), part->rows.data(), part->count, ndims, comparisonCount) < part->count) {
+                    isDominated = true;
+                    break;
+                }
+            }
+            if (!isDominated) {
+                group.push_back(i);
+            }
+        }
+
+        local.clear();
+        bskytreeItems(dataset, group, local, comparisonCount);
+        RegionSkyline<T> part;
+        part.region = region;
+        part.count = local.size();
+        part.rows.reserve(local.size() * ndims);
+        for (auto i : local) {
+            part.rows.insert(part.rows.end(), &dataset(i,0), &dataset(i,0) + ndims);
+        }
+        done.push_back(std::move(part));
+        skyline.insert(skyline.end(), local.begin(), local.end());
+    }
+}
+
+template<typename T>
+void bskytree(const BasicDataset<T>& dataset, Skyline& skyline, size_type& comparisonCount) {
+    skyline.clear();
+    comparisonCount = 0;
+    Skyline items(dataset.size());
+    std::iota(items.begin(), items.end(), 0);
+    bskytreeItems(dataset, items, skyline, comparisonCount);
+}
+
+#define BSKYTREE_INSTANTIATE(T) \
+    template void bskytree<T>(const BasicDataset<T>&, Skyline&, size_type&);
+SKYLINE_VALUE_TYPES(BSKYTREE_INSTANTIATE)
+#undef BSKYTREE_INSTANTIATE
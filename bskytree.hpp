@@ -0,0 +1,27 @@
+#ifndef BSKYTREE_HPP_
+#define BSKYTREE_HPP_
+
+#include "common.hpp"
+
+/**
+ * Compute noisless skyline by recursive partitioning around pivot items
+ * (Lee and Hwang "BSkyTree: Scalable Skyline Computation Using a Balanced Pivot Selection", EDBT '10).
+ *
+ * The pivot is a skyline item with balanced values over all dimensions.
+ * Every other item is encoded by the bitmask of the dimensions where it is not less than the pivot;
+ * an item can only be dominated by items whose bitmask is a superset of its own,
+ * so dominance tests between incomparable regions are skipped.
+ * Regions are processed from supersets to subsets, and the skyline of each region is computed recursively
+ * after dropping the items dominated by the skylines of its superset regions.
+ * Unlike noisless(), the cost does not grow with the size of the skyline,
+ * which makes it suitable for anti-correlated and high-dimensional data.
+ *
+ * Sets comparisonCount to the number of performed comparisons;
+ * encoding an item relative to the pivot counts as one comparison per dimension,
+ * and comparisons made to pick balanced pivots are not counted.
+ * Instantiated for every type of values in SKYLINE_VALUE_TYPES.
+ */
+template<typename T>
+void bskytree(const BasicDataset<T>& dataset, Skyline& skyline, size_type& comparisonCount);
+
+#endif // BSKYTREE_HPP_
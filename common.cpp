@@ -1,40 +1,251 @@
 #include "common.hpp"
 
+#include <algorithm>
 #include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
 #include <string>
 #include <fstream>
 
-Dataset::Dataset(size_type size, size_type ndims)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+ValueType valueTypeParse(const char* s) {
+    if (std::strcmp(s, "double") == 0) {
+        return ValueType::float64;
+    } else if (std::strcmp(s, "float") == 0) {
+        return ValueType::float32;
+    } else if (std::strcmp(s, "int32") == 0) {
+        return ValueType::int32;
+    } else if (std::strcmp(s, "uint16") == 0) {
+        return ValueType::uint16;
+    }
+    throw std::runtime_error(std::string("Unknown value type: ") + s);
+}
+
+template<typename T>
+BasicDataset<T>::BasicDataset(size_type size, size_type ndims)
+        : size_(size), ndims_(ndims), storage_(new T[size * ndims], std::default_delete<T[]>()) {
+}
+
+template<typename T>
+BasicDataset<T>::BasicDataset(size_type size, size_type ndims, std::shared_ptr<T> storage)
+        : size_(size), ndims_(ndims), storage_(storage) {
+}
+
+template<typename T>
+size_type BasicDataset<T>::size() const {
+    return size_;
+}
+
+template<typename T>
+size_type BasicDataset<T>::ndims() const {
+    return ndims_;
+}
+
+template<typename T>
+T* BasicDataset<T>::data() {
+    return storage_.get();
+}
+
+template<typename T>
+const T* BasicDataset<T>::data() const {
+    return storage_.get();
+}
+
+template<typename T>
+T& BasicDataset<T>::operator()(size_type item, size_type dim) {
+    return storage_.get()[ndims_ * item + dim];
+}
+
+template<typename T>
+const T& BasicDataset<T>::operator()(size_type item, size_type dim) const {
+    return storage_.get()[ndims_ * item + dim];
+}
+
+template<typename T>
+BasicColumnarDataset<T>::BasicColumnarDataset(size_type size, size_type ndims)
         : size_(size), ndims_(ndims), storage_(size * ndims) {
 }
 
-size_type Dataset::size() const {
+template<typename T>
+BasicColumnarDataset<T>::BasicColumnarDataset(const BasicDataset<T>& dataset)
+        : size_(dataset.size()), ndims_(dataset.ndims()), storage_(size_ * ndims_) {
+    for (size_type i = 0; i < size_; i++) {
+        for (size_type k = 0; k < ndims_; k++) {
+            (*this)(i,k) = dataset(i,k);
+        }
+    }
+}
+
+template<typename T>
+size_type BasicColumnarDataset<T>::size() const {
     return size_;
 }
 
-size_type Dataset::ndims() const {
+template<typename T>
+size_type BasicColumnarDataset<T>::ndims() const {
     return ndims_;
 }
 
-value_type* Dataset::data() {
-    return storage_.data();
+template<typename T>
+T* BasicColumnarDataset<T>::column(size_type dim) {
+    return storage_.data() + size_ * dim;
+}
+
+template<typename T>
+const T* BasicColumnarDataset<T>::column(size_type dim) const {
+    return storage_.data() + size_ * dim;
+}
+
+template<typename T>
+T& BasicColumnarDataset<T>::operator()(size_type item, size_type dim) {
+    return storage_[size_ * dim + item];
 }
 
-const value_type* Dataset::data() const {
-    return storage_.data();
+template<typename T>
+const T& BasicColumnarDataset<T>::operator()(size_type item, size_type dim) const {
+    return storage_[size_ * dim + item];
 }
 
-value_type& Dataset::operator()(size_type item, size_type dim) {
-    return storage_[ndims_ * item + dim];
+/** Throw std::runtime_error describing the last system error. */
+[[noreturn]] static void systemError(const std::string& what, const char* filename) {
+    throw std::runtime_error(what + " " + filename + ": " + std::strerror(errno));
 }
 
-const value_type& Dataset::operator()(size_type item, size_type dim) const {
-    return storage_[ndims_ * item + dim];
+/** Check that the dataset file holds exactly size * ndims values of valueSize bytes. */
+static void datasetCheckSize(const char* filename, off_t fileSize, size_type size, size_type ndims,
+        size_type valueSize) {
+    // Neither the number of values nor the number of bytes may wrap around.
+    auto count = size * ndims;
+    if ((ndims != 0 && count / ndims != size) || count > std::numeric_limits<size_type>::max() / valueSize) {
+        throw std::runtime_error(std::string("dataset is too large for ") + filename);
+    }
+    if (fileSize < 0 || static_cast<size_type>(fileSize) != count * valueSize) {
+        throw std::runtime_error(std::string(filename) + ": expected " + std::to_string(count * valueSize)
+                + " bytes for " + std::to_string(size) + " items of " + std::to_string(ndims)
+                + " dimensions, found " + std::to_string(fileSize));
+    }
 }
 
-void datasetRead(Dataset& dataset, const char* filename) {
+template<typename T>
+BasicDataset<T> datasetMap(const char* filename, size_type size, size_type ndims, MapHint hint) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        systemError("cannot open", filename);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        systemError("cannot stat", filename);
+    }
+    try {
+        datasetCheckSize(filename, info.st_size, size, ndims, sizeof(T));
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+
+    auto length = static_cast<size_type>(info.st_size);
+    if (length == 0) {
+        close(fd);
+        return BasicDataset<T>(size, ndims, std::shared_ptr<T>());
+    }
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (hint == MapHint::populate) {
+        flags |= MAP_POPULATE;
+    }
+#endif
+    void* address = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, fd, 0);
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+    if (address == MAP_FAILED) {
+        systemError("cannot map", filename);
+    }
+    switch (hint) {
+        case MapHint::sequential: {
+            madvise(address, length, MADV_SEQUENTIAL);
+            break;
+        }
+        case MapHint::random: {
+            madvise(address, length, MADV_RANDOM);
+            break;
+        }
+        case MapHint::populate: {
+            madvise(address, length, MADV_WILLNEED);
+            break;
+        }
+        case MapHint::normal: {
+            break;
+        }
+    }
+
+    std::shared_ptr<T> storage(static_cast<T*>(address), [length](T* p) {
+        munmap(p, length);
+    });
+    return BasicDataset<T>(size, ndims, storage);
+}
+
+FILE* datasetOpen(const char* filename, size_type size, size_type ndims, size_type valueSize) {
     FILE* f = std::fopen(filename, "rb");
-    std::fread(dataset.data(), sizeof(value_type), dataset.size() * dataset.ndims(), f);
+    if (f == nullptr) {
+        systemError("cannot open", filename);
+    }
+    struct stat info;
+    if (fstat(fileno(f), &info) != 0) {
+        std::fclose(f);
+        systemError("cannot stat", filename);
+    }
+    try {
+        datasetCheckSize(filename, info.st_size, size, ndims, valueSize);
+    } catch (...) {
+        std::fclose(f);
+        throw;
+    }
+    return f;
+}
+
+/** Read exactly count values from the dataset file, or close it and throw. */
+template<typename T>
+static void datasetReadValues(FILE* f, T* values, size_type count, const char* filename) {
+    if (std::fread(values, sizeof(T), count, f) != count) {
+        std::fclose(f);
+        throw std::runtime_error(std::string("cannot read ") + filename);
+    }
+}
+
+template<typename T>
+void datasetRead(BasicDataset<T>& dataset, const char* filename) {
+    FILE* f = datasetOpen(filename, dataset.size(), dataset.ndims(), sizeof(T));
+    datasetReadValues(f, dataset.data(), dataset.size() * dataset.ndims(), filename);
+    std::fclose(f);
+}
+
+template<typename T>
+void datasetRead(BasicColumnarDataset<T>& dataset, const char* filename) {
+    // Transpose the file through a bounded buffer of rows.
+    const size_type blockSize = 4096;
+    std::vector<T> block(blockSize * dataset.ndims());
+    FILE* f = datasetOpen(filename, dataset.size(), dataset.ndims(), sizeof(T));
+    for (size_type begin = 0; begin < dataset.size(); begin += blockSize) {
+        auto count = std::min(blockSize, dataset.size() - begin);
+        datasetReadValues(f, block.data(), count * dataset.ndims(), filename);
+        for (size_type k = 0; k < dataset.ndims(); k++) {
+            for (size_type r = 0; r < count; r++) {
+                dataset(begin + r, k) = block[r * dataset.ndims() + k];
+            }
+        }
+    }
     std::fclose(f);
 }
 
@@ -53,3 +264,546 @@ void skylineWrite(const Skyline& skyline, const char* filename) {
     }
     f.close();
 }
+
+/**
+ * Find the first dimension on which item a is greater than item b (gt),
+ * and the first dimension on which item a is less than item b (lt);
+ * ndims stands for "no such dimension". Dimensions after gt are not examined.
+ */
+template<typename T>
+static inline void scanScalar(const T* a, const T* b, size_type ndims, size_type& gt, size_type& lt) {
+    gt = ndims;
+    lt = ndims;
+    for (size_type k = 0; k < ndims; k++) {
+        if (a[k] > b[k]) {
+            gt = k;
+            return;
+        }
+        if (lt == ndims && a[k] < b[k]) {
+            lt = k;
+        }
+    }
+}
+
+/**
+ * Number of comparisons made by the scalar early-exit loop, given the result of a scan:
+ * one "greater" test per dimension up to and including gt,
+ * and one "less" test per dimension before gt up to and including lt.
+ */
+static inline size_type scanComparisons(size_type gt, size_type lt, size_type ndims) {
+    return std::min(gt + 1, ndims) + std::min(lt + 1, gt);
+}
+
+/** Is the scan result a dominance? */
+static inline bool scanDominated(size_type gt, size_type lt, size_type ndims) {
+    return gt == ndims && lt < ndims;
+}
+
+template<size_type D, typename T>
+static bool dominatedByScalar(const T* a, const T* b, size_type ndims, size_type& comparisonCount) {
+    ndims = fixedDims<D>(ndims);
+    size_type gt, lt;
+    scanScalar(a, b, ndims, gt, lt);
+    comparisonCount += scanComparisons(gt, lt, ndims);
+    return scanDominated(gt, lt, ndims);
+}
+
+template<size_type D, typename T>
+static size_type findDominatorScalar(const T* a, const T* rows, size_type count, size_type ndims,
+        size_type& comparisonCount) {
+    ndims = fixedDims<D>(ndims);
+    for (size_type r = 0; r < count; r++) {
+        size_type gt, lt;
+        scanScalar(a, rows + r * ndims, ndims, gt, lt);
+        comparisonCount += scanComparisons(gt, lt, ndims);
+        if (scanDominated(gt, lt, ndims)) {
+            return r;
+        }
+    }
+    return count;
+}
+
+template<size_type D, typename T>
+static size_type markDominatedScalar(const T* a, const T* rows, size_type count, size_type ndims,
+        unsigned char* dominated, size_type& comparisonCount) {
+    ndims = fixedDims<D>(ndims);
+    size_type total = 0;
+    for (size_type r = 0; r < count; r++) {
+        size_type gt, lt;
+        scanScalar(rows + r * ndims, a, ndims, gt, lt);
+        comparisonCount += scanComparisons(gt, lt, ndims);
+        dominated[r] = scanDominated(gt, lt, ndims);
+        total += dominated[r];
+    }
+    return total;
+}
+
+/** Number of items processed together by the columnar kernels. */
+static const size_type COLUMNAR_BLOCK = 256;
+
+/**
+ * Scan items [begin; end) of a columnar dataset against item a, one dimension at a time;
+ * the same as scanScalar(a, item) for every item when Reverse is false,
+ * and as scanScalar(item, a) when Reverse is true.
+ * The branchless loop over a block is left for the compiler to vectorize.
+ */
+template <bool Reverse, size_type D, typename T>
+__attribute__((always_inline))
+static inline void scanColumnar(const T* a, const BasicColumnarDataset<T>& dataset, size_type begin, size_type end,
+        size_type* gt, size_type* lt) {
+    auto ndims = fixedDims<D>(dataset.ndims());
+    auto count = end - begin;
+    std::fill(gt, gt + count, ndims);
+    std::fill(lt, lt + count, ndims);
+    for (size_type k = 0; k < ndims; k++) {
+        const T* column = dataset.column(k) + begin;
+        const T value = a[k];
+        for (size_type r = 0; r < count; r++) {
+            bool greater = Reverse ? column[r] > value : value > column[r];
+            bool less = Reverse ? column[r] < value : value < column[r];
+            bool open = gt[r] == ndims;
+            gt[r] = (open && greater) ? k : gt[r];
+            lt[r] = (open && less && lt[r] == ndims) ? k : lt[r];
+        }
+    }
+}
+
+template<size_type D, typename T>
+__attribute__((always_inline))
+static inline size_type findDominatorColumnarWith(const T* a, const BasicColumnarDataset<T>& dataset,
+        size_type begin, size_type end, size_type& comparisonCount) {
+    auto ndims = fixedDims<D>(dataset.ndims());
+    size_type gt[COLUMNAR_BLOCK], lt[COLUMNAR_BLOCK];
+    // Dominators are often found early, so start with small blocks and grow them.
+    size_type block = 16;
+    for (size_type first = begin; first < end; first += block, block = std::min(2 * block, COLUMNAR_BLOCK)) {
+        auto last = std::min(first + block, end);
+        scanColumnar<false, D>(a, dataset, first, last, gt, lt);
+        for (size_type r = 0; r < last - first; r++) {
+            comparisonCount += scanComparisons(gt[r], lt[r], ndims);
+            if (scanDominated(gt[r], lt[r], ndims)) {
+                return first + r;
+            }
+        }
+    }
+    return end;
+}
+
+template<size_type D, typename T>
+__attribute__((always_inline))
+static inline size_type markDominatedColumnarWith(const T* a, const BasicColumnarDataset<T>& dataset,
+        size_type begin, size_type end, unsigned char* dominated, size_type& comparisonCount) {
+    auto ndims = fixedDims<D>(dataset.ndims());
+    size_type gt[COLUMNAR_BLOCK], lt[COLUMNAR_BLOCK];
+    size_type total = 0;
+    for (size_type first = begin; first < end; first += COLUMNAR_BLOCK) {
+        auto last = std::min(first + COLUMNAR_BLOCK, end);
+        scanColumnar<true, D>(a, dataset, first, last, gt, lt);
+        for (size_type r = 0; r < last - first; r++) {
+            comparisonCount += scanComparisons(gt[r], lt[r], ndims);
+            dominated[first - begin + r] = scanDominated(gt[r], lt[r], ndims);
+            total += dominated[first - begin + r];
+        }
+    }
+    return total;
+}
+
+template<size_type D, typename T>
+static size_type findDominatorColumnarScalar(const T* a, const BasicColumnarDataset<T>& dataset,
+        size_type begin, size_type end, size_type& comparisonCount) {
+    return findDominatorColumnarWith<D>(a, dataset, begin, end, comparisonCount);
+}
+
+template<size_type D, typename T>
+static size_type markDominatedColumnarScalar(const T* a, const BasicColumnarDataset<T>& dataset,
+        size_type begin, size_type end, unsigned char* dominated, size_type& comparisonCount) {
+    return markDominatedColumnarWith<D>(a, dataset, begin, end, dominated, comparisonCount);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/** Masks of the first 0 to 8 lanes of 32-bit values, at offsets 8 down to 0. */
+static const int tailMasks32[16] = {-1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0};
+
+/** Masks of the first 0 to 4 lanes of 64-bit values, at offsets 4 down to 0. */
+static const long long tailMasks64[8] = {-1, -1, -1, -1, 0, 0, 0, 0};
+
+/*
+ * Compare the first count (at most 32 bytes) values of items a and b;
+ * the bits of byte i of gt (lt) are set if lane i of a is greater (less) than lane i of b,
+ * so the lane of a bit is its position divided by the size of a value.
+ * Missing lanes are loaded as zeros, which are neither greater nor less.
+ */
+
+__attribute__((target("avx2")))
+static inline void compareAvx2(const double* a, const double* b, size_type count, unsigned& gt, unsigned& lt) {
+    __m256d va, vb;
+    if (count >= 4) {
+        va = _mm256_loadu_pd(a);
+        vb = _mm256_loadu_pd(b);
+    } else {
+        auto mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tailMasks64 + 4 - count));
+        va = _mm256_maskload_pd(a, mask);
+        vb = _mm256_maskload_pd(b, mask);
+    }
+    gt = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castpd_si256(_mm256_cmp_pd(va, vb, _CMP_GT_OQ))));
+    lt = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castpd_si256(_mm256_cmp_pd(va, vb, _CMP_LT_OQ))));
+}
+
+__attribute__((target("avx2")))
+static inline void compareAvx2(const float* a, const float* b, size_type count, unsigned& gt, unsigned& lt) {
+    __m256 va, vb;
+    if (count >= 8) {
+        va = _mm256_loadu_ps(a);
+        vb = _mm256_loadu_ps(b);
+    } else {
+        auto mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tailMasks32 + 8 - count));
+        va = _mm256_maskload_ps(a, mask);
+        vb = _mm256_maskload_ps(b, mask);
+    }
+    gt = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castps_si256(_mm256_cmp_ps(va, vb, _CMP_GT_OQ))));
+    lt = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castps_si256(_mm256_cmp_ps(va, vb, _CMP_LT_OQ))));
+}
+
+/** Load the first pairs pairs of 16-bit values (or the first pairs 32-bit values) from p. */
+__attribute__((target("avx2")))
+static inline __m256i loadPairsAvx2(const void* p, size_type pairs) {
+    if (pairs >= 8) {
+        return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+    }
+    auto mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tailMasks32 + 8 - pairs));
+    return _mm256_maskload_epi32(static_cast<const int*>(p), mask);
+}
+
+__attribute__((target("avx2")))
+static inline void compareAvx2(const std::int32_t* a, const std::int32_t* b, size_type count,
+        unsigned& gt, unsigned& lt) {
+    auto va = loadPairsAvx2(a, count);
+    auto vb = loadPairsAvx2(b, count);
+    gt = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi32(va, vb)));
+    lt = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi32(vb, va)));
+}
+
+__attribute__((target("avx2")))
+static inline void compareAvx2(const std::uint16_t* a, const std::uint16_t* b, size_type count,
+        unsigned& gt, unsigned& lt) {
+    // Masked loads work with 32-bit lanes, so an odd last value is compared separately.
+    // There are only signed comparisons of integers, so flip the sign bits.
+    auto bias = _mm256_set1_epi16(std::numeric_limits<short>::min());
+    auto va = _mm256_xor_si256(loadPairsAvx2(a, count / 2), bias);
+    auto vb = _mm256_xor_si256(loadPairsAvx2(b, count / 2), bias);
+    gt = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi16(va, vb)));
+    lt = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi16(vb, va)));
+    if (count < 16 && count % 2 != 0) {
+        auto last = count - 1;
+        gt |= (a[last] > b[last]) ? 3u << (2 * last) : 0u;
+        lt |= (a[last] < b[last]) ? 3u << (2 * last) : 0u;
+    }
+}
+
+/** Same as scanScalar(), 32 bytes of values at a time. */
+template<typename T>
+__attribute__((target("avx2")))
+static inline void scanAvx2(const T* a, const T* b, size_type ndims, size_type& gt, size_type& lt) {
+    const size_type lanes = 32 / sizeof(T);
+    gt = ndims;
+    lt = ndims;
+    for (size_type k = 0; k < ndims; k += lanes) {
+        unsigned gtMask, ltMask;
+        compareAvx2(a + k, b + k, std::min(lanes, ndims - k), gtMask, ltMask);
+        if (lt == ndims && ltMask != 0) {
+            lt = k + static_cast<size_type>(__builtin_ctz(ltMask)) / sizeof(T);
+        }
+        if (gtMask != 0) {
+            gt = k + static_cast<size_type>(__builtin_ctz(gtMask)) / sizeof(T);
+            return;
+        }
+    }
+}
+
+template<size_type D, typename T>
+__attribute__((target("avx2")))
+static bool dominatedByAvx2(const T* a, const T* b, size_type ndims, size_type& comparisonCount) {
+    ndims = fixedDims<D>(ndims);
+    size_type gt, lt;
+    scanAvx2(a, b, ndims, gt, lt);
+    comparisonCount += scanComparisons(gt, lt, ndims);
+    return scanDominated(gt, lt, ndims);
+}
+
+template<size_type D, typename T>
+__attribute__((target("avx2")))
+static size_type findDominatorAvx2(const T* a, const T* rows, size_type count, size_type ndims,
+        size_type& comparisonCount) {
+    ndims = fixedDims<D>(ndims);
+    for (size_type r = 0; r < count; r++) {
+        size_type gt, lt;
+        scanAvx2(a, rows + r * ndims, ndims, gt, lt);
+        comparisonCount += scanComparisons(gt, lt, ndims);
+        if (scanDominated(gt, lt, ndims)) {
+            return r;
+        }
+    }
+    return count;
+}
+
+template<size_type D, typename T>
+__attribute__((target("avx2")))
+static size_type markDominatedAvx2(const T* a, const T* rows, size_type count, size_type ndims,
+        unsigned char* dominated, size_type& comparisonCount) {
+    ndims = fixedDims<D>(ndims);
+    size_type total = 0;
+    for (size_type r = 0; r < count; r++) {
+        size_type gt, lt;
+        scanAvx2(rows + r * ndims, a, ndims, gt, lt);
+        comparisonCount += scanComparisons(gt, lt, ndims);
+        dominated[r] = scanDominated(gt, lt, ndims);
+        total += dominated[r];
+    }
+    return total;
+}
+
+template<size_type D, typename T>
+__attribute__((target("avx2")))
+static size_type findDominatorColumnarAvx2(const T* a, const BasicColumnarDataset<T>& dataset,
+        size_type begin, size_type end, size_type& comparisonCount) {
+    return findDominatorColumnarWith<D>(a, dataset, begin, end, comparisonCount);
+}
+
+template<size_type D, typename T>
+__attribute__((target("avx2")))
+static size_type markDominatedColumnarAvx2(const T* a, const BasicColumnarDataset<T>& dataset,
+        size_type begin, size_type end, unsigned char* dominated, size_type& comparisonCount) {
+    return markDominatedColumnarWith<D>(a, dataset, begin, end, dominated, comparisonCount);
+}
+
+/*
+ * Compare the first count (at most 64 bytes) values of items a and b;
+ * bit i of gt (lt) is set if value i of a is greater (less) than value i of b.
+ */
+
+__attribute__((target("avx512f")))
+static inline void compareAvx512(const double* a, const double* b, size_type count,
+        std::uint64_t& gt, std::uint64_t& lt) {
+    auto mask = static_cast<__mmask8>((count >= 8) ? 0xff : (1u << count) - 1);
+    auto va = _mm512_maskz_loadu_pd(mask, a);
+    auto vb = _mm512_maskz_loadu_pd(mask, b);
+    gt = _mm512_cmp_pd_mask(va, vb, _CMP_GT_OQ);
+    lt = _mm512_cmp_pd_mask(va, vb, _CMP_LT_OQ);
+}
+
+__attribute__((target("avx512f")))
+static inline void compareAvx512(const float* a, const float* b, size_type count,
+        std::uint64_t& gt, std::uint64_t& lt) {
+    auto mask = static_cast<__mmask16>((count >= 16) ? 0xffff : (1u << count) - 1);
+    auto va = _mm512_maskz_loadu_ps(mask, a);
+    auto vb = _mm512_maskz_loadu_ps(mask, b);
+    gt = _mm512_cmp_ps_mask(va, vb, _CMP_GT_OQ);
+    lt = _mm512_cmp_ps_mask(va, vb, _CMP_LT_OQ);
+}
+
+__attribute__((target("avx512f")))
+static inline void compareAvx512(const std::int32_t* a, const std::int32_t* b, size_type count,
+        std::uint64_t& gt, std::uint64_t& lt) {
+    auto mask = static_cast<__mmask16>((count >= 16) ? 0xffff : (1u << count) - 1);
+    auto va = _mm512_maskz_loadu_epi32(mask, a);
+    auto vb = _mm512_maskz_loadu_epi32(mask, b);
+    gt = _mm512_cmpgt_epi32_mask(va, vb);
+    lt = _mm512_cmplt_epi32_mask(va, vb);
+}
+
+/** Same as scanScalar(), 64 bytes of values at a time. */
+template<typename T>
+__attribute__((target("avx512f")))
+static inline void scanAvx512(const T* a, const T* b, size_type ndims, size_type& gt, size_type& lt) {
+    const size_type lanes = 64 / sizeof(T);
+    gt = ndims;
+    lt = ndims;
+    for (size_type k = 0; k < ndims; k += lanes) {
+        // Masked-out lanes are loaded as zeros, which are neither greater nor less.
+        std::uint64_t gtMask, ltMask;
+        compareAvx512(a + k, b + k, std::min(lanes, ndims - k), gtMask, ltMask);
+        if (lt == ndims && ltMask != 0) {
+            lt = k + static_cast<size_type>(__builtin_ctzll(ltMask));
+        }
+        if (gtMask != 0) {
+            gt = k + static_cast<size_type>(__builtin_ctzll(gtMask));
+            return;
+        }
+    }
+}
+
+/** Comparisons of 16-bit values need AVX-512BW, so they are made with AVX2. */
+__attribute__((target("avx512f")))
+static inline void scanAvx512(const std::uint16_t* a, const std::uint16_t* b, size_type ndims,
+        size_type& gt, size_type& lt) {
+    scanAvx2(a, b, ndims, gt, lt);
+}
+
+template<size_type D, typename T>
+__attribute__((target("avx512f")))
+static bool dominatedByAvx512(const T* a, const T* b, size_type ndims, size_type& comparisonCount) {
+    ndims = fixedDims<D>(ndims);
+    size_type gt, lt;
+    scanAvx512(a, b, ndims, gt, lt);
+    comparisonCount += scanComparisons(gt, lt, ndims);
+    return scanDominated(gt, lt, ndims);
+}
+
+template<size_type D, typename T>
+__attribute__((target("avx512f")))
+static size_type findDominatorAvx512(const T* a, const T* rows, size_type count, size_type ndims,
+        size_type& comparisonCount) {
+    ndims = fixedDims<D>(ndims);
+    for (size_type r = 0; r < count; r++) {
+        size_type gt, lt;
+        scanAvx512(a, rows + r * ndims, ndims, gt, lt);
+        comparisonCount += scanComparisons(gt, lt, ndims);
+        if (scanDominated(gt, lt, ndims)) {
+            return r;
+        }
+    }
+    return count;
+}
+
+template<size_type D, typename T>
+__attribute__((target("avx512f")))
+static size_type markDominatedAvx512(const T* a, const T* rows, size_type count, size_type ndims,
+        unsigned char* dominated, size_type& comparisonCount) {
+    ndims = fixedDims<D>(ndims);
+    size_type total = 0;
+    for (size_type r = 0; r < count; r++) {
+        size_type gt, lt;
+        scanAvx512(rows + r * ndims, a, ndims, gt, lt);
+        comparisonCount += scanComparisons(gt, lt, ndims);
+        dominated[r] = scanDominated(gt, lt, ndims);
+        total += dominated[r];
+    }
+    return total;
+}
+
+template<size_type D, typename T>
+__attribute__((target("avx512f")))
+static size_type findDominatorColumnarAvx512(const T* a, const BasicColumnarDataset<T>& dataset,
+        size_type begin, size_type end, size_type& comparisonCount) {
+    return findDominatorColumnarWith<D>(a, dataset, begin, end, comparisonCount);
+}
+
+template<size_type D, typename T>
+__attribute__((target("avx512f")))
+static size_type markDominatedColumnarAvx512(const T* a, const BasicColumnarDataset<T>& dataset,
+        size_type begin, size_type end, unsigned char* dominated, size_type& comparisonCount) {
+    return markDominatedColumnarWith<D>(a, dataset, begin, end, dominated, comparisonCount);
+}
+#endif
+
+/** Set of kernel implementations for one instruction set, one type of values and one number of dimensions. */
+template<typename T>
+struct Kernels {
+    const char* name;
+    bool (*dominatedBy)(const T*, const T*, size_type, size_type&);
+    size_type (*findDominator)(const T*, const T*, size_type, size_type, size_type&);
+    size_type (*markDominated)(const T*, const T*, size_type, size_type, unsigned char*, size_type&);
+    size_type (*findDominatorColumnar)(const T*, const BasicColumnarDataset<T>&, size_type, size_type, size_type&);
+    size_type (*markDominatedColumnar)(const T*, const BasicColumnarDataset<T>&, size_type, size_type,
+            unsigned char*, size_type&);
+};
+
+/**
+ * Pick the best kernels supported by the CPU, unless overridden by SKYLINE_KERNEL;
+ * specialized for D dimensions, or generic if D is 0.
+ */
+template<size_type D, typename T>
+static Kernels<T> kernelsSelect() {
+    const Kernels<T> scalar = {"scalar", dominatedByScalar<D, T>, findDominatorScalar<D, T>, markDominatedScalar<D, T>,
+            findDominatorColumnarScalar<D, T>, markDominatedColumnarScalar<D, T>};
+    const char* requested = std::getenv("SKYLINE_KERNEL");
+    if (requested != nullptr && std::strcmp(requested, "scalar") == 0) {
+        return scalar;
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    bool any = requested == nullptr;
+    if ((any || std::strcmp(requested, "avx512") == 0) && __builtin_cpu_supports("avx512f")) {
+        return Kernels<T>{"avx512", dominatedByAvx512<D, T>, findDominatorAvx512<D, T>, markDominatedAvx512<D, T>,
+                findDominatorColumnarAvx512<D, T>, markDominatedColumnarAvx512<D, T>};
+    }
+    if ((any || std::strcmp(requested, "avx2") == 0) && __builtin_cpu_supports("avx2")) {
+        return Kernels<T>{"avx2", dominatedByAvx2<D, T>, findDominatorAvx2<D, T>, markDominatedAvx2<D, T>,
+                findDominatorColumnarAvx2<D, T>, markDominatedColumnarAvx2<D, T>};
+    }
+#endif
+    return scalar;
+}
+
+/** Kernels for ndims dimensions, selected on the first use. */
+template<typename T>
+static const Kernels<T>& kernels(size_type ndims) {
+    switch (ndims) {
+#define KERNELS_FIXED(D) \
+        case D: { \
+            static const Kernels<T> fixed = kernelsSelect<D, T>(); \
+            return fixed; \
+        }
+        SKYLINE_FIXED_DIMS(KERNELS_FIXED)
+#undef KERNELS_FIXED
+        default: {
+            static const Kernels<T> generic = kernelsSelect<0, T>();
+            return generic;
+        }
+    }
+}
+
+const char* kernelName() {
+    return kernels<value_type>(0).name;
+}
+
+template<typename T>
+bool dominatedBy(const T* a, const T* b, size_type ndims, size_type& comparisonCount) {
+    return kernels<T>(ndims).dominatedBy(a, b, ndims, comparisonCount);
+}
+
+template<typename T>
+DominatedByKernel<T> dominatedByKernel(size_type ndims) {
+    return kernels<T>(ndims).dominatedBy;
+}
+
+template<typename T>
+size_type findDominator(const T* a, const T* rows, size_type count, size_type ndims,
+        size_type& comparisonCount) {
+    return kernels<T>(ndims).findDominator(a, rows, count, ndims, comparisonCount);
+}
+
+template<typename T>
+size_type markDominated(const T* a, const T* rows, size_type count, size_type ndims,
+        unsigned char* dominated, size_type& comparisonCount) {
+    return kernels<T>(ndims).markDominated(a, rows, count, ndims, dominated, comparisonCount);
+}
+
+template<typename T>
+size_type findDominator(const T* a, const BasicColumnarDataset<T>& dataset, size_type begin, size_type end,
+        size_type& comparisonCount) {
+    return kernels<T>(dataset.ndims()).findDominatorColumnar(a, dataset, begin, end, comparisonCount);
+}
+
+template<typename T>
+size_type markDominated(const T* a, const BasicColumnarDataset<T>& dataset, size_type begin, size_type end,
+        unsigned char* dominated, size_type& comparisonCount) {
+    return kernels<T>(dataset.ndims()).markDominatedColumnar(a, dataset, begin, end, dominated, comparisonCount);
+}
+
+#define COMMON_INSTANTIATE(T) \
+    template class BasicDataset<T>; \
+    template class BasicColumnarDataset<T>; \
+    template BasicDataset<T> datasetMap<T>(const char*, size_type, size_type, MapHint); \
+    template void datasetRead<T>(BasicDataset<T>&, const char*); \
+    template void datasetRead<T>(BasicColumnarDataset<T>&, const char*); \
+    template bool dominatedBy<T>(const T*, const T*, size_type, size_type&); \
+    template DominatedByKernel<T> dominatedByKernel<T>(size_type); \
+    template size_type findDominator<T>(const T*, const T*, size_type, size_type, size_type&); \
+    template size_type markDominated<T>(const T*, const T*, size_type, size_type, unsigned char*, size_type&); \
+    template size_type findDominator<T>(const T*, const BasicColumnarDataset<T>&, size_type, size_type, size_type&); \
+    template size_type markDominated<T>(const T*, const BasicColumnarDataset<T>&, size_type, size_type, \
+            unsigned char*, size_type&);
+SKYLINE_VALUE_TYPES(COMMON_INSTANTIATE)
+#undef COMMON_INSTANTIATE
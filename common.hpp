@@ -2,29 +2,129 @@
 #define COMMON_HPP_
 
 #include <cstddef>
+#include <cstdio>
+#include <cstdint>
+#include <limits>
+#include <memory>
 #include <vector>
 
 using size_type = std::size_t;
+/** Type of values of the default dataset; the only one supported by the noisy algorithm. */
 using value_type = double;
 
-/** Simple wrapper for dataset storage. */
-class Dataset {
+/** Types of values supported by the datasets and the dominance kernels. */
+enum class ValueType {
+    float64,
+    float32,
+    int32,
+    uint16,
+};
+
+/**
+ * Convert string ("double", "float", "int32" or "uint16") to value type.
+ *
+ * @throws std::runtime_error if the string is not a name of a value type.
+ */
+ValueType valueTypeParse(const char* s);
+
+/*
+ * Apply macro X to every C++ type of values, e.g. to explicitly instantiate templates
+ * that are defined in translation units.
+ */
+#define SKYLINE_VALUE_TYPES(X) \
+    X(double) \
+    X(float) \
+    X(std::int32_t) \
+    X(std::uint16_t)
+
+/**
+ * Simple wrapper for dataset storage, with values of type T.
+ * The storage is either allocated (and left uninitialized) by the constructor,
+ * or mapped from a file by datasetMap(); copies of a dataset share the same storage.
+ */
+template<typename T>
+class BasicDataset {
 public:
-    Dataset(size_type size, size_type ndims);
+    BasicDataset(size_type size, size_type ndims);
+    BasicDataset(size_type size, size_type ndims, std::shared_ptr<T> storage);
     size_type size() const;
     size_type ndims() const;
-    value_type* data();
-    const value_type* data() const;
-    value_type& operator()(size_type item, size_type dim);
-    const value_type& operator()(size_type item, size_type dim) const;
+    T* data();
+    const T* data() const;
+    T& operator()(size_type item, size_type dim);
+    const T& operator()(size_type item, size_type dim) const;
 private:
     const size_type size_;
     const size_type ndims_;
-    std::vector<value_type> storage_;
+    std::shared_ptr<T> storage_;
 };
 
-/** Fill dataset with data from binary file in row-major format. */
-void datasetRead(Dataset& dataset, const char* filename);
+using Dataset = BasicDataset<value_type>;
+
+/**
+ * Column-major dataset storage: values of each dimension are stored contiguously,
+ * so that scans of many items can stream one dimension at a time.
+ */
+template<typename T>
+class BasicColumnarDataset {
+public:
+    BasicColumnarDataset(size_type size, size_type ndims);
+    explicit BasicColumnarDataset(const BasicDataset<T>& dataset);
+    size_type size() const;
+    size_type ndims() const;
+    T* column(size_type dim);
+    const T* column(size_type dim) const;
+    T& operator()(size_type item, size_type dim);
+    const T& operator()(size_type item, size_type dim) const;
+private:
+    const size_type size_;
+    const size_type ndims_;
+    std::vector<T> storage_;
+};
+
+using ColumnarDataset = BasicColumnarDataset<value_type>;
+
+/** Access pattern hint for datasetMap(). */
+enum class MapHint {
+    /** Pages are read on the first access. */
+    normal,
+    /** Pages are read on the first access, with aggressive read-ahead. */
+    sequential,
+    /** Pages are read on the first access, without read-ahead. */
+    random,
+    /** All pages are read while mapping. */
+    populate,
+};
+
+/**
+ * Map dataset from binary file in row-major format, using the file itself as the storage.
+ * The mapping is private: changes to the dataset are never written back to the file.
+ *
+ * @throws std::runtime_error if the file cannot be mapped, or does not hold exactly size * ndims values.
+ */
+template<typename T = value_type>
+BasicDataset<T> datasetMap(const char* filename, size_type size, size_type ndims, MapHint hint = MapHint::normal);
+
+/**
+ * Fill dataset with data from binary file in row-major format.
+ *
+ * @throws std::runtime_error if the file cannot be read, or does not hold exactly size * ndims values.
+ */
+template<typename T>
+void datasetRead(BasicDataset<T>& dataset, const char* filename);
+
+/** Same as datasetRead(), for a columnar dataset. */
+template<typename T>
+void datasetRead(BasicColumnarDataset<T>& dataset, const char* filename);
+
+/**
+ * Open binary dataset file in row-major format for reading,
+ * and check that it holds exactly size * ndims values of valueSize bytes.
+ *
+ * @throws std::runtime_error if the file cannot be opened, or has a wrong size.
+ */
+std::FILE* datasetOpen(const char* filename, size_type size, size_type ndims,
+        size_type valueSize = sizeof(value_type));
 
 /** Convert string to dataset count/dimension. */
 size_type datasetSizeParse(const char* s);
@@ -32,7 +132,115 @@ size_type datasetSizeParse(const char* s);
 /** Simple container for skyline indices. */
 using Skyline = std::vector<size_type>;
 
+/** "Not found" skyline index. */
+const size_type NULL_SKYLINE = std::numeric_limits<size_type>::max();
+
 /** Write skyline indices to a file. */
 void skylineWrite(const Skyline& skyline, const char* filename);
 
+/**
+ * Philox4x32-10 counter-based random number generator
+ * (Salmon et al. "Parallel random numbers: as easy as 1, 2, 3", SC '11).
+ * Maps a 128-bit counter (here: a 64-bit counter and a 64-bit stream) and a 64-bit key to 64 random bits.
+ * Every output depends only on its inputs, so outputs can be computed in any order, in batches or in parallel.
+ * Defined in the header, so that loops over many counters can be inlined and vectorized.
+ */
+inline std::uint64_t philox(std::uint64_t counter, std::uint64_t stream, std::uint64_t key) {
+    auto c0 = static_cast<std::uint32_t>(counter);
+    auto c1 = static_cast<std::uint32_t>(counter >> 32);
+    auto c2 = static_cast<std::uint32_t>(stream);
+    auto c3 = static_cast<std::uint32_t>(stream >> 32);
+    auto k0 = static_cast<std::uint32_t>(key);
+    auto k1 = static_cast<std::uint32_t>(key >> 32);
+    for (int round = 0; round < 10; round++) {
+        auto product0 = std::uint64_t{0xD2511F53} * c0;
+        auto product1 = std::uint64_t{0xCD9E8D57} * c2;
+        c0 = static_cast<std::uint32_t>(product1 >> 32) ^ c1 ^ k0;
+        c2 = static_cast<std::uint32_t>(product0 >> 32) ^ c3 ^ k1;
+        c1 = static_cast<std::uint32_t>(product1);
+        c3 = static_cast<std::uint32_t>(product0);
+        k0 += 0x9E3779B9;
+        k1 += 0xBB67AE85;
+    }
+    return (std::uint64_t{c1} << 32) | c0;
+}
+
+/** Uniformly distributed double in the range [0.0; 1.0) from 64 random bits. */
+inline double uniformCanonical(std::uint64_t bits) {
+    return static_cast<double>(bits >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/*
+ * Dominance test kernels.
+ *
+ * Items are rows of ndims contiguous values of type T (any of SKYLINE_VALUE_TYPES);
+ * item a is dominated by item b if a is not greater than b on every dimension and is less than b on at least one.
+ * Kernels are specialized for the numbers of dimensions in SKYLINE_FIXED_DIMS,
+ * and vectorized with AVX2 or AVX-512 when the CPU supports it
+ * (the scalar fallback can be forced by setting SKYLINE_KERNEL=scalar in the environment),
+ * so narrower types compare more dimensions at a time;
+ * but always add to comparisonCount the number of scalar comparisons
+ * that the early-exit loop over dimensions would perform.
+ */
+
+/*
+ * Apply macro X to every number of dimensions with specialized kernels,
+ * where the loops over dimensions are unrolled at compile time;
+ * other numbers of dimensions use the generic kernels.
+ */
+#define SKYLINE_FIXED_DIMS(X) X(2) X(3) X(4) X(8) X(16)
+
+/** Number of dimensions of code specialized for D dimensions, or ndims for the generic code (D = 0). */
+template<size_type D>
+constexpr size_type fixedDims(size_type ndims) {
+    return (D != 0) ? D : ndims;
+}
+
+/** Name of the kernel implementation in use: "avx512", "avx2" or "scalar". */
+const char* kernelName();
+
+/** Is item a dominated by item b? */
+template<typename T>
+bool dominatedBy(const T* a, const T* b, size_type ndims, size_type& comparisonCount);
+
+/** Implementation of dominatedBy() for some number of dimensions. */
+template<typename T>
+using DominatedByKernel = bool (*)(const T* a, const T* b, size_type ndims, size_type& comparisonCount);
+
+/** Implementation of dominatedBy() for ndims dimensions, so that loops over many pairs dispatch only once. */
+template<typename T>
+DominatedByKernel<T> dominatedByKernel(size_type ndims);
+
+/**
+ * Find the first of count contiguous rows that dominates item a.
+ *
+ * @return index of the dominating row, or count if item a is not dominated by any of them.
+ */
+template<typename T>
+size_type findDominator(const T* a, const T* rows, size_type count, size_type ndims,
+        size_type& comparisonCount);
+
+/**
+ * Find all of count contiguous rows that are dominated by item a.
+ * Sets dominated[r] to 1 if row r is dominated by item a, and to 0 otherwise.
+ *
+ * @return number of dominated rows.
+ */
+template<typename T>
+size_type markDominated(const T* a, const T* rows, size_type count, size_type ndims,
+        unsigned char* dominated, size_type& comparisonCount);
+
+/** Same as findDominator(), for the items [begin; end) of a columnar dataset. */
+template<typename T>
+size_type findDominator(const T* a, const BasicColumnarDataset<T>& dataset, size_type begin, size_type end,
+        size_type& comparisonCount);
+
+/**
+ * Same as markDominated(), for the items [begin; end) of a columnar dataset.
+ * Sets dominated[r] for the item begin + r.
+ */
+template<typename T>
+size_type markDominated(const T* a, const BasicColumnarDataset<T>& dataset, size_type begin, size_type end,
+        unsigned char* dominated, size_type& comparisonCount);
+
 #endif // COMMON_HPP_
@@ -0,0 +1,158 @@
+#include "datagen.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** Number of items generated and written at once by datagenWrite(). */
+static const size_type DATAGEN_BLOCK = 65536;
+
+/**
+ * Random numbers drawn from the Philox stream of one item;
+ * the same as in the original generator by Börzsönyi et al.
+ */
+class ItemRandom {
+public:
+    ItemRandom(std::uint64_t seed, size_type item)
+            : seed_(seed), item_(item), counter_(0) {
+    }
+
+    /** Uniformly distributed in [min; max). */
+    double equal(double min, double max) {
+        return min + (max - min) * uniformCanonical(philox(counter_++, item_, seed_));
+    }
+
+    /** Mean of count uniformly distributed values in [min; max). */
+    double peak(double min, double max, size_type count) {
+        double sum = 0;
+        for (size_type c = 0; c < count; c++) {
+            sum += equal(min, max);
+        }
+        return sum / static_cast<double>(count);
+    }
+
+    /** Approximately normally distributed around median, within [median - spread; median + spread). */
+    double normal(double median, double spread) {
+        return peak(median - spread, median + spread, 12);
+    }
+
+private:
+    const std::uint64_t seed_;
+    const std::uint64_t item_;
+    std::uint64_t counter_;
+};
+
+Distribution distributionParse(const char* s) {
+    if (std::strcmp(s, "independent") == 0) {
+        return Distribution::independent;
+    } else if (std::strcmp(s, "correlated") == 0) {
+        return Distribution::correlated;
+    } else if (std::strcmp(s, "anticorrelated") == 0) {
+        return Distribution::anticorrelated;
+    }
+    throw std::runtime_error(std::string("Unknown distribution: ") + s);
+}
+
+void datagenItem(Distribution distribution, std::uint64_t seed, size_type item, size_type ndims, value_type* values) {
+    ItemRandom random(seed, item);
+    if (distribution == Distribution::independent) {
+        for (size_type k = 0; k < ndims; k++) {
+            values[k] = random.equal(0, 1);
+        }
+        return;
+    }
+    // Start from a point on the diagonal, and move the value between adjacent dimensions,
+    // so that the sum of the values stays the same; retry if any value leaves the range.
+    while (true) {
+        double v = (distribution == Distribution::correlated)
+                ? random.peak(0, 1, ndims) : random.normal(0.5, 0.25);
+        double l = (v <= 0.5) ? v : 1.0 - v;
+        std::fill_n(values, ndims, v);
+        for (size_type k = 0; k < ndims; k++) {
+            double h = (distribution == Distribution::correlated) ? random.normal(0, l) : random.equal(-l, l);
+            values[k] += h;
+            values[(k + 1) % ndims] -= h;
+        }
+        bool inside = std::all_of(values, values + ndims, [](value_type x) {
+            return x >= 0 && x < 1;
+        });
+        if (inside) {
+            return;
+        }
+    }
+}
+
+void datagenFill(Dataset& dataset, Distribution distribution, std::uint64_t seed, ThreadPool& pool) {
+    pool.parallelFor(0, dataset.size(), [&](size_type i) {
+        datagenItem(distribution, seed, i, dataset.ndims(), &dataset(i,0));
+    });
+}
+
+/** Convert the generated value in [0.0; 1.0) to type T. */
+template<typename T>
+static T datagenConvert(double value) {
+    const double scale = static_cast<double>(std::numeric_limits<T>::max()) + 1;
+    return static_cast<T>(std::is_floating_point<T>::value ? value : value * scale);
+}
+
+template<typename T>
+void datagenWrite(const char* filename, size_type size, size_type ndims,
+        Distribution distribution, std::uint64_t seed, ThreadPool& pool) {
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("cannot open ") + filename + ": " + std::strerror(errno));
+    }
+    try {
+        auto length = static_cast<off_t>(size * ndims * sizeof(T));
+        if (ftruncate(fd, length) != 0) {
+            throw std::runtime_error(std::string("cannot resize ") + filename + ": " + std::strerror(errno));
+        }
+        // Every block is written at its own offset, so blocks can be written in any order.
+        size_type blockCount = (size + DATAGEN_BLOCK - 1) / DATAGEN_BLOCK;
+        pool.parallelFor(0, blockCount, [&](size_type block) {
+            size_type begin = block * DATAGEN_BLOCK;
+            size_type end = std::min(size, begin + DATAGEN_BLOCK);
+            std::vector<value_type> item(ndims);
+            std::vector<T> values((end - begin) * ndims);
+            for (size_type i = begin; i < end; i++) {
+                datagenItem(distribution, seed, i, ndims, item.data());
+                std::transform(item.begin(), item.end(), &values[(i - begin) * ndims], datagenConvert<T>);
+            }
+            auto bytes = reinterpret_cast<const char*>(values.data());
+            size_type remaining = values.size() * sizeof(T);
+            auto offset = static_cast<off_t>(begin * ndims * sizeof(T));
+            while (remaining > 0) {
+                auto written = pwrite(fd, bytes, remaining, offset);
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::runtime_error(std::string("cannot write ") + filename + ": " + std::strerror(errno));
+                }
+                bytes += written;
+                remaining -= static_cast<size_type>(written);
+                offset += written;
+            }
+        });
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+    if (close(fd) != 0) {
+        throw std::runtime_error(std::string("cannot close ") + filename + ": " + std::strerror(errno));
+    }
+}
+
+#define DATAGEN_INSTANTIATE(T) \
+    template void datagenWrite<T>(const char*, size_type, size_type, Distribution, std::uint64_t, ThreadPool&);
+SKYLINE_VALUE_TYPES(DATAGEN_INSTANTIATE)
+#undef DATAGEN_INSTANTIATE
@@ -0,0 +1,52 @@
+#ifndef DATAGEN_HPP_
+#define DATAGEN_HPP_
+
+#include <cstdint>
+
+#include "common.hpp"
+#include "threadpool.hpp"
+
+/**
+ * Distributions of the synthetic datasets
+ * (Börzsönyi et al. "The Skyline Operator", ICDE '01).
+ * All values are in the range [0.0; 1.0).
+ */
+enum class Distribution {
+    /** Every value is uniformly distributed, independently of the others. */
+    independent,
+    /** Items that are good on one dimension tend to be good on the others. */
+    correlated,
+    /** Items that are good on one dimension tend to be bad on the others. */
+    anticorrelated,
+};
+
+/**
+ * Convert string ("independent", "correlated" or "anticorrelated") to distribution.
+ *
+ * @throws std::runtime_error if the string is not a name of a distribution.
+ */
+Distribution distributionParse(const char* s);
+
+/**
+ * Generate the values of one item.
+ * Random numbers are drawn from the Philox stream of the item,
+ * so the values depend only on the seed and the item index, and items can be generated in any order.
+ */
+void datagenItem(Distribution distribution, std::uint64_t seed, size_type item, size_type ndims, value_type* values);
+
+/** Fill the dataset with generated items in parallel. */
+void datagenFill(Dataset& dataset, Distribution distribution, std::uint64_t seed, ThreadPool& pool);
+
+/**
+ * Write generated items to binary file in row-major format, in parallel,
+ * as values of type T (any of SKYLINE_VALUE_TYPES): floating-point values are rounded,
+ * and integer values are scaled to all non-negative values of T and truncated.
+ * Items are generated and written in blocks, so the memory used does not depend on the size of the dataset.
+ *
+ * @throws std::runtime_error if the file cannot be written.
+ */
+template<typename T = value_type>
+void datagenWrite(const char* filename, size_type size, size_type ndims,
+        Distribution distribution, std::uint64_t seed, ThreadPool& pool);
+
+#endif // DATAGEN_HPP_
@@ -0,0 +1,64 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "datagen.hpp"
+
+/** Main entry point. */
+int main(int argc, char** argv) {
+    const char* type = "double";
+    if (argc >= 3 && std::strcmp(argv[argc - 2], "--type") == 0) {
+        type = argv[argc - 1];
+        argc -= 2;
+    }
+    if (argc < 5 || argc > 7) {
+        std::cerr << "Usage: " << argv[0] << " output size dimensions independent|correlated|anticorrelated"
+                << " [seed [threads]] [--type double|float|int32|uint16]" << std::endl;
+        std::cerr << "Threads default to all hardware threads." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto output = argv[1];
+    auto size = datasetSizeParse(argv[2]);
+    auto dimensions = datasetSizeParse(argv[3]);
+    std::uint64_t seed = (argc >= 6) ? std::stoull(argv[5]) : std::random_device()();
+    auto threads = (argc >= 7) ? datasetSizeParse(argv[6]) : 0;
+
+    try {
+        auto distribution = distributionParse(argv[4]);
+
+        ThreadPool pool(threads);
+        auto beforeTime = std::chrono::steady_clock::now();
+        switch (valueTypeParse(type)) {
+            case ValueType::float64: {
+                datagenWrite<double>(output, size, dimensions, distribution, seed, pool);
+                break;
+            }
+            case ValueType::float32: {
+                datagenWrite<float>(output, size, dimensions, distribution, seed, pool);
+                break;
+            }
+            case ValueType::int32: {
+                datagenWrite<std::int32_t>(output, size, dimensions, distribution, seed, pool);
+                break;
+            }
+            case ValueType::uint16: {
+                datagenWrite<std::uint16_t>(output, size, dimensions, distribution, seed, pool);
+                break;
+            }
+        }
+        auto afterTime = std::chrono::steady_clock::now();
+
+        auto runningTime = std::chrono::duration_cast<std::chrono::milliseconds>(afterTime - beforeTime).count();
+        std::cout << runningTime << std::endl;
+
+        return EXIT_SUCCESS;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
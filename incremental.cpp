@@ -0,0 +1,159 @@
+#include "incremental.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+template<typename Dominance>
+IncrementalSkyline<Dominance>::IncrementalSkyline(Dominance& dominance)
+        : dominance_(dominance), owner_(dominance.itemCount(), NULL_SKYLINE), owned_(dominance.itemCount()),
+          ownedPosition_(dominance.itemCount(), 0), present_(dominance.itemCount(), false),
+          size_(0), dominanceTestCount_(0) {
+}
+
+template<typename Dominance>
+void IncrementalSkyline<Dominance>::insert(size_type item, double tolerance) {
+    if (item >= present_.size() || present_[item]) {
+        throw std::invalid_argument("Item " + std::to_string(item) + " cannot be inserted");
+    }
+    present_[item] = true;
+    size_++;
+    place(item, tolerance);
+}
+
+template<typename Dominance>
+void IncrementalSkyline<Dominance>::remove(size_type item, double tolerance) {
+    if (item >= present_.size() || !present_[item]) {
+        throw std::invalid_argument("Item " + std::to_string(item) + " cannot be removed");
+    }
+    present_[item] = false;
+    size_--;
+
+    auto owner = owner_[item];
+    if (owner != NULL_SKYLINE) {
+        // Move the last owned item into the place of the removed one.
+        auto& owned = owned_[owner];
+        auto position = ownedPosition_[item];
+        owned[position] = owned.back();
+        ownedPosition_[owned[position]] = position;
+        owned.pop_back();
+        owner_[item] = NULL_SKYLINE;
+        return;
+    }
+
+    for (size_type s = 0; s < skyline_.size(); s++) {
+        if (skyline_[s] == item) {
+            skyline_[s] = skyline_.back();
+            skyline_.pop_back();
+            break;
+        }
+    }
+    // Only the owned items can join the skyline. None of them dominates a remaining skyline item,
+    // which would then be dominated by the removed item, so they are simply placed again.
+    Skyline orphans;
+    std::swap(orphans, owned_[item]);
+    for (auto orphan : orphans) {
+        owner_[orphan] = NULL_SKYLINE;
+    }
+    for (auto orphan : orphans) {
+        place(orphan, tolerance / static_cast<double>(orphans.size()));
+    }
+}
+
+template<typename Dominance>
+const Skyline& IncrementalSkyline<Dominance>::skyline() const {
+    return skyline_;
+}
+
+template<typename Dominance>
+size_type IncrementalSkyline<Dominance>::size() const {
+    return size_;
+}
+
+template<typename Dominance>
+bool IncrementalSkyline<Dominance>::contains(size_type item) const {
+    return item < present_.size() && present_[item];
+}
+
+template<typename Dominance>
+size_type IncrementalSkyline<Dominance>::dominanceTestCount() const {
+    return dominanceTestCount_;
+}
+
+template<typename Dominance>
+void IncrementalSkyline<Dominance>::place(size_type item, double tolerance) {
+    // At most one test against every skyline item, and one more to find the skyline items that the item dominates.
+    double share = tolerance / static_cast<double>(2 * std::max<size_type>(skyline_.size(), 1));
+    for (auto s : skyline_) {
+        dominanceTestCount_++;
+        if (dominance_.dominatedBy(item, s, share)) {
+            own(s, item);
+            return;
+        }
+    }
+
+    // The item joins the skyline; the skyline items that it dominates are owned by it with their owned items.
+    size_type kept = 0;
+    for (size_type s = 0; s < skyline_.size(); s++) {
+        auto other = skyline_[s];
+        dominanceTestCount_++;
+        if (dominance_.dominatedBy(other, item, share)) {
+            Skyline owned;
+            std::swap(owned, owned_[other]);
+            for (auto o : owned) {
+                own(item, o);
+            }
+            own(item, other);
+        } else {
+            skyline_[kept++] = other;
+        }
+    }
+    skyline_.resize(kept);
+    skyline_.push_back(item);
+}
+
+template<typename Dominance>
+void IncrementalSkyline<Dominance>::own(size_type owner, size_type item) {
+    owner_[item] = owner;
+    ownedPosition_[item] = owned_[owner].size();
+    owned_[owner].push_back(item);
+}
+
+template class IncrementalSkyline<ExactDominance>;
+template class IncrementalSkyline<NoisyDominance>;
+
+ExactDominance::ExactDominance(const Dataset& dataset)
+        : dataset_(dataset), comparisonCount_(0) {
+}
+
+size_type ExactDominance::itemCount() const {
+    return dataset_.size();
+}
+
+bool ExactDominance::dominatedBy(size_type i, size_type j, double) {
+    return ::dominatedBy(&dataset_(i,0), &dataset_(j,0), dataset_.ndims(), comparisonCount_);
+}
+
+size_type ExactDominance::comparisonCount() const {
+    return comparisonCount_;
+}
+
+NoisyDominance::NoisyDominance(Oracle& oracle, const NoisyOptions& options, NoisyStats& stats)
+        : oracle_(oracle), options_(options), stats_(stats) {
+}
+
+size_type NoisyDominance::itemCount() const {
+    return oracle_.itemCount();
+}
+
+bool NoisyDominance::dominatedBy(size_type i, size_type j, double tolerance) {
+    if (!(tolerance > 0)) {
+        throw std::invalid_argument("Tolerance of noisy dominance tests must be positive");
+    }
+    return noisyDominatedBy(oracle_, i, j, tolerance, options_, stats_);
+}
+
+size_type NoisyDominance::comparisonCount() const {
+    return oracle_.comparisonCount();
+}
@@ -0,0 +1,125 @@
+#ifndef INCREMENTAL_HPP_
+#define INCREMENTAL_HPP_
+
+#include <vector>
+
+#include "common.hpp"
+#include "noisy.hpp"
+
+/**
+ * Skyline of a changing set of items, maintained under inserts and deletes.
+ *
+ * Every item that is not in the skyline is owned by one skyline item that dominates it,
+ * so the owned items are the only candidates to replace a deleted skyline item.
+ * An insert tests the item only against the skyline: if some skyline item dominates it,
+ * that item becomes its owner; otherwise the item joins the skyline,
+ * and takes over the skyline items that it dominates together with their owned items.
+ * A delete of a skyline item inserts its owned items again.
+ * Therefore, the cost of an update depends on the size of the skyline
+ * (and on the number of owned items for deletes), but not on the total number of items.
+ *
+ * Items are indices in [0; dominance.itemCount()).
+ * Dominance tests are answered by the Dominance policy (ExactDominance or NoisyDominance),
+ * which must provide itemCount() and dominatedBy(i, j, tolerance).
+ * Every update is wrong with probability at most the tolerance passed to it,
+ * which is split between the dominance tests of the update.
+ */
+template<typename Dominance>
+class IncrementalSkyline {
+public:
+    /** Construct the empty set of items; the policy must outlive the skyline. */
+    explicit IncrementalSkyline(Dominance& dominance);
+
+    /**
+     * Add the item to the set.
+     *
+     * @throws std::invalid_argument if the item is out of range or already in the set.
+     */
+    void insert(size_type item, double tolerance = 0.0);
+
+    /**
+     * Remove the item from the set.
+     *
+     * @throws std::invalid_argument if the item is not in the set.
+     */
+    void remove(size_type item, double tolerance = 0.0);
+
+    /** Skyline items of the set, in no particular order. */
+    const Skyline& skyline() const;
+
+    /** Number of items in the set. */
+    size_type size() const;
+
+    /** Is the item in the set? */
+    bool contains(size_type item) const;
+
+    /** Total number of dominance tests made by all updates. */
+    size_type dominanceTestCount() const;
+
+private:
+    /** Make the item a skyline item or an owned item, splitting the tolerance between the tests. */
+    void place(size_type item, double tolerance);
+
+    /** Add the item to the items owned by the owner. */
+    void own(size_type owner, size_type item);
+
+    Dominance& dominance_;
+    Skyline skyline_;
+    /** Owner of each item, or NULL_SKYLINE for skyline items and items that are not in the set. */
+    std::vector<size_type> owner_;
+    /** Items owned by each skyline item. */
+    std::vector<Skyline> owned_;
+    /** Position of each owned item in the items of its owner. */
+    std::vector<size_type> ownedPosition_;
+    std::vector<unsigned char> present_;
+    size_type size_;
+    size_type dominanceTestCount_;
+};
+
+/** Exact dominance tests over the values of a dataset; the tolerance is ignored. */
+class ExactDominance {
+public:
+    /**
+     * Construct the policy; the dataset storage is shared,
+     * so the values of the items may be written after construction, but before their insertion.
+     */
+    explicit ExactDominance(const Dataset& dataset);
+
+    size_type itemCount() const;
+
+    /** Is item i dominated by item j? */
+    bool dominatedBy(size_type i, size_type j, double tolerance);
+
+    /** Total number of comparisons of values. */
+    size_type comparisonCount() const;
+
+private:
+    const Dataset dataset_;
+    size_type comparisonCount_;
+};
+
+/** Dominance tests with the noisy oracle, using the comparisons of noisy(). */
+class NoisyDominance {
+public:
+    /** Construct the policy; the oracle, options and statistics must outlive it. */
+    NoisyDominance(Oracle& oracle, const NoisyOptions& options, NoisyStats& stats);
+
+    size_type itemCount() const;
+
+    /**
+     * Is item i dominated by item j? The result is wrong with probability at most tolerance.
+     *
+     * @throws std::invalid_argument if the tolerance is not positive.
+     */
+    bool dominatedBy(size_type i, size_type j, double tolerance);
+
+    /** Total number of queries to the oracle. */
+    size_type comparisonCount() const;
+
+private:
+    Oracle& oracle_;
+    const NoisyOptions& options_;
+    NoisyStats& stats_;
+};
+
+#endif // INCREMENTAL_HPP_
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "datagen.hpp"
+#include "incremental.hpp"
+#include "skyline.hpp"
+
+/*
+ * Random inserts and deletes on a generated dataset: after every update,
+ * the skyline maintained by IncrementalSkyline is compared with the skyline of the items in the set,
+ * computed from scratch with block-nested-loops.
+ */
+
+/** Exact skyline of the items of the dataset, sorted by item index. */
+static Skyline exactSkyline(const Dataset& dataset, const std::vector<size_type>& items) {
+    Skyline skyline;
+    if (items.empty()) {
+        return skyline;
+    }
+    Dataset subset(items.size(), dataset.ndims());
+    for (size_type k = 0; k < items.size(); k++) {
+        std::copy_n(&dataset(items[k],0), dataset.ndims(), &subset(k,0));
+    }
+    SkylineOptions options;
+    options.algorithm = Algorithm::bnl;
+    SkylineStats stats;
+    skylineCompute(subset, options, skyline, stats);
+    for (auto& item : skyline) {
+        item = items[item];
+    }
+    std::sort(skyline.begin(), skyline.end());
+    return skyline;
+}
+
+/** Move a random item from one set to the other. */
+static size_type transfer(std::vector<size_type>& from, std::vector<size_type>& to, std::mt19937_64& random) {
+    auto k = std::uniform_int_distribution<size_type>(0, from.size() - 1)(random);
+    auto item = from[k];
+    from[k] = from.back();
+    from.pop_back();
+    to.push_back(item);
+    return item;
+}
+
+/**
+ * Apply the random updates, each with its share of the tolerance, and check the skyline after every one of them.
+ *
+ * @return number of updates after which the skyline was wrong.
+ */
+template<typename Dominance>
+static size_type run(const Dataset& dataset, Dominance& dominance, size_type updates, double tolerance,
+        std::uint64_t seed, size_type& dominanceTestCount) {
+    IncrementalSkyline<Dominance> incremental(dominance);
+    std::vector<size_type> inside;
+    std::vector<size_type> outside(dataset.size());
+    for (size_type i = 0; i < outside.size(); i++) {
+        outside[i] = i;
+    }
+
+    std::mt19937_64 random(seed);
+    std::bernoulli_distribution insertion(0.6);
+    size_type wrongCount = 0;
+    for (size_type update = 0; update < updates; update++) {
+        if (inside.empty() || (!outside.empty() && insertion(random))) {
+            incremental.insert(transfer(outside, inside, random), tolerance / static_cast<double>(updates));
+        } else {
+            incremental.remove(transfer(inside, outside, random), tolerance / static_cast<double>(updates));
+        }
+
+        Skyline skyline = incremental.skyline();
+        std::sort(skyline.begin(), skyline.end());
+        if (incremental.size() != inside.size() || skyline != exactSkyline(dataset, inside)) {
+            wrongCount++;
+        }
+    }
+    dominanceTestCount = incremental.dominanceTestCount();
+    return wrongCount;
+}
+
+/** Main entry point. */
+int main(int argc, char** argv) {
+    if (argc < 5 || argc > 8 || argc == 7) {
+        std::cerr << "Usage: " << argv[0] << " size dimensions updates independent|correlated|anticorrelated"
+                << " [seed [tolerance error_probability]]" << std::endl;
+        std::cerr << "Dominance tests are exact, unless an error probability is given;"
+                << " the tolerance is split equally between the updates." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        auto size = datasetSizeParse(argv[1]);
+        auto dimensions = datasetSizeParse(argv[2]);
+        auto updates = datasetSizeParse(argv[3]);
+        auto distribution = distributionParse(argv[4]);
+        std::uint64_t seed = (argc >= 6) ? std::stoull(argv[5]) : std::random_device()();
+        double tolerance = (argc >= 8) ? std::stod(argv[6]) : 0.0;
+        double errorProbability = (argc >= 8) ? std::stod(argv[7]) : 0.0;
+
+        Dataset dataset(size, dimensions);
+        ThreadPool pool(0);
+        datagenFill(dataset, distribution, seed, pool);
+
+        size_type wrongCount = 0;
+        size_type dominanceTestCount = 0;
+        auto beforeTime = std::chrono::steady_clock::now();
+        if (errorProbability > 0.0) {
+            Oracle oracle(dataset, errorProbability, seed);
+            NoisyOptions options;
+            NoisyStats stats;
+            NoisyDominance dominance(oracle, options, stats);
+            wrongCount = run(dataset, dominance, updates, tolerance, seed, dominanceTestCount);
+        } else {
+            ExactDominance dominance(dataset);
+            wrongCount = run(dataset, dominance, updates, tolerance, seed, dominanceTestCount);
+        }
+        auto afterTime = std::chrono::steady_clock::now();
+
+        auto runningTime = std::chrono::duration_cast<std::chrono::milliseconds>(afterTime - beforeTime).count();
+        std::cout << runningTime << " " << dominanceTestCount << " " << wrongCount << std::endl;
+
+        // Exact updates are never wrong; noisy ones make the run wrong with probability at most the tolerance.
+        return (errorProbability > 0.0 || wrongCount == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
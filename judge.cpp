@@ -0,0 +1,198 @@
+#include "judge.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include <unistd.h>
+
+Judge::~Judge() {
+}
+
+void Judge::lessAsync(const ItemPair* pairs, const size_type* dims, size_type count, std::future<bool>* results) {
+    for (size_type q = 0; q < count; q++) {
+        results[q] = less(pairs[q].i, pairs[q].j, dims[q]);
+    }
+}
+
+void Judge::lessBatch(const ItemPair* pairs, const size_type* dims, size_type count, unsigned char* results) {
+    // Reused by all batches in the thread, so that batches do not allocate once it has grown.
+    static thread_local std::vector<std::future<bool>> answers;
+    answers.resize(std::max(answers.size(), count));
+    lessAsync(pairs, dims, count, answers.data());
+    for (size_type q = 0; q < count; q++) {
+        results[q] = answers[q].get();
+    }
+}
+
+/** Number of low bits of a query id that hold its slot. */
+static const unsigned SLOT_BITS = 24;
+
+static const std::uint64_t SLOT_MASK = (std::uint64_t(1) << SLOT_BITS) - 1;
+
+ProcessJudge::ProcessJudge(const std::vector<std::string>& command, size_type itemCount, size_type itemDimension,
+        double errorProbability)
+        : itemCount_(itemCount), itemDimension_(itemDimension), errorProbability_(errorProbability),
+          process_(command), nextSequence_(0), closed_(false) {
+    reader_ = std::thread(&ProcessJudge::receive, this);
+}
+
+ProcessJudge::~ProcessJudge() {
+    process_.closeInput();
+    reader_.join();
+}
+
+size_type ProcessJudge::itemCount() const {
+    return itemCount_;
+}
+
+size_type ProcessJudge::itemDimension() const {
+    return itemDimension_;
+}
+
+double ProcessJudge::errorProbability() const {
+    return errorProbability_;
+}
+
+std::future<bool> ProcessJudge::less(size_type i, size_type j, size_type k) {
+    ItemPair pair{i, j};
+    std::future<bool> result;
+    lessAsync(&pair, &k, 1, &result);
+    return result;
+}
+
+void ProcessJudge::lessAsync(const ItemPair* pairs, const size_type* dims, size_type count,
+        std::future<bool>* results) {
+    send(pairs, dims, count, nullptr, results);
+}
+
+void ProcessJudge::lessBatch(const ItemPair* pairs, const size_type* dims, size_type count, unsigned char* results) {
+    if (count == 0) {
+        return;
+    }
+    Batch batch;
+    batch.results = results;
+    batch.remaining = count;
+    batch.failed = false;
+    send(pairs, dims, count, &batch, nullptr);
+    std::unique_lock<std::mutex> lock(mutex_);
+    batch.done.wait(lock, [&]() { return batch.remaining == 0; });
+    if (batch.failed) {
+        throw std::runtime_error("Judge exited without an answer");
+    }
+}
+
+void ProcessJudge::send(const ItemPair* pairs, const size_type* dims, size_type count, Batch* batch,
+        std::future<bool>* futures) {
+    // Reused by all calls in the thread, so that calls do not allocate once they have grown.
+    static thread_local std::string lines;
+    static thread_local std::vector<std::uint64_t> sent;
+    lines.clear();
+    sent.clear();
+    std::lock_guard<std::mutex> writeLock(writeMutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_) {
+            throw std::runtime_error("Judge exited");
+        }
+        for (size_type q = 0; q < count; q++) {
+            std::uint64_t slot;
+            if (freeSlots_.empty()) {
+                if (slots_.size() > SLOT_MASK) {
+                    for (auto taken : sent) {
+                        release(taken);
+                    }
+                    throw std::runtime_error("Too many queries to judge in flight");
+                }
+                slot = slots_.size();
+                slots_.push_back(Slot());
+            } else {
+                slot = freeSlots_.back();
+                freeSlots_.pop_back();
+            }
+            auto id = (nextSequence_++ << SLOT_BITS) | slot;
+            slots_[slot] = Slot{id, true, batch, q};
+            if (batch == nullptr) {
+                futures[q] = promises_[slot].get_future();
+            }
+            sent.push_back(slot);
+            char line[96];
+            auto length = std::snprintf(line, sizeof(line), "%llu %llu %llu %llu\n", static_cast<unsigned long long>(id),
+                    static_cast<unsigned long long>(pairs[q].i), static_cast<unsigned long long>(pairs[q].j),
+                    static_cast<unsigned long long>(dims[q]));
+            lines.append(line, static_cast<size_type>(length));
+        }
+    }
+    // Written without holding mutex_: a judge that stops reading queries until its answers are read
+    // would otherwise block the writer and the reader forever.
+    size_type written = 0;
+    while (written < lines.size()) {
+        auto n = write(process_.input(), lines.data() + written, lines.size() - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            int error = errno;
+            // Futures of the queries get broken promises; the batch is not touched once its slots are released.
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto slot : sent) {
+                if (slots_[slot].used) {
+                    release(slot);
+                }
+            }
+            throw std::runtime_error(std::string("Cannot send queries to judge: ") + std::strerror(error));
+        }
+        written += static_cast<size_type>(n);
+    }
+}
+
+void ProcessJudge::release(std::uint64_t slot) {
+    slots_[slot].used = false;
+    promises_.erase(slot);
+    freeSlots_.push_back(slot);
+}
+
+void ProcessJudge::receive() {
+    std::FILE* f = fdopen(dup(process_.output()), "r");
+    if (f != nullptr) {
+        unsigned long long id;
+        int answer;
+        while (std::fscanf(f, "%llu %d", &id, &answer) == 2) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto slot = id & SLOT_MASK;
+            if (slot >= slots_.size() || !slots_[slot].used || slots_[slot].id != id) {
+                continue;
+            }
+            auto batch = slots_[slot].batch;
+            if (batch != nullptr) {
+                batch->results[slots_[slot].index] = answer != 0;
+                if (--batch->remaining == 0) {
+                    batch->done.notify_one();
+                }
+            } else {
+                promises_[slot].set_value(answer != 0);
+            }
+            release(slot);
+        }
+        std::fclose(f);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    for (std::uint64_t slot = 0; slot < slots_.size(); slot++) {
+        if (!slots_[slot].used) {
+            continue;
+        }
+        auto batch = slots_[slot].batch;
+        if (batch != nullptr) {
+            batch->failed = true;
+            if (--batch->remaining == 0) {
+                batch->done.notify_one();
+            }
+        } else {
+            promises_[slot].set_exception(std::make_exception_ptr(std::runtime_error("Judge exited without an answer")));
+        }
+        release(slot);
+    }
+}
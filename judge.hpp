@@ -0,0 +1,148 @@
+#ifndef JUDGE_HPP_
+#define JUDGE_HPP_
+
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common.hpp"
+#include "process.hpp"
+
+/** Pair of items to compare; used in Oracle::lessBatch() and Judge::lessAsync(). */
+struct ItemPair {
+    size_type i;
+    size_type j;
+};
+
+/**
+ * External source of answers to the queries "Is i-th item less than j-th item on dimension k?",
+ * such as human labelling or a model behind a service, which answers with latency and with errors.
+ *
+ * Queries are asynchronous, so that many independent queries can be in flight at once:
+ * a caller issues all queries it already knows it needs, and only then waits for the answers.
+ * Implementations must be thread-safe.
+ */
+class Judge {
+public:
+    virtual ~Judge();
+
+    /** Total number of items. */
+    virtual size_type itemCount() const = 0;
+
+    /** Dimension of every item. */
+    virtual size_type itemDimension() const = 0;
+
+    /** Probability that an answer is wrong; the same for every query. */
+    virtual double errorProbability() const = 0;
+
+    /** Issue the query; the future holds the answer. */
+    virtual std::future<bool> less(size_type i, size_type j, size_type k) = 0;
+
+    /**
+     * Issue count queries (pairs[q].i, pairs[q].j, dims[q]) at once, storing their futures in results.
+     * By default, issues them one by one.
+     */
+    virtual void lessAsync(const ItemPair* pairs, const size_type* dims, size_type count,
+            std::future<bool>* results);
+
+    /**
+     * Issue count queries at once, and wait for all their answers, storing them in results.
+     * By default, waits for the futures of lessAsync().
+     */
+    virtual void lessBatch(const ItemPair* pairs, const size_type* dims, size_type count, unsigned char* results);
+};
+
+/**
+ * Judge served by a child process over its standard input and output, e.g. skyline_oracle_service.
+ *
+ * Every query is sent as the line "id i j k", and answered by the line "id 0" or "id 1",
+ * where answers may come in any order; queries of one lessAsync() or lessBatch() call are sent together.
+ * A reader thread fulfills the futures, or stores the answers of a batch, as the answers arrive.
+ *
+ * Every query in flight takes a slot, whose number is in the low bits of the id;
+ * slots are reused, so that lessBatch() does not allocate once enough slots have been made.
+ */
+class ProcessJudge : public Judge {
+public:
+    /**
+     * Start the command, whose first element is the path of the executable.
+     *
+     * @throws std::runtime_error if the process cannot be started.
+     */
+    ProcessJudge(const std::vector<std::string>& command, size_type itemCount, size_type itemDimension,
+            double errorProbability);
+
+    /** Close the input of the process, wait for the remaining answers and for the process to exit. */
+    ~ProcessJudge() override;
+
+    ProcessJudge(const ProcessJudge&) = delete;
+    ProcessJudge& operator=(const ProcessJudge&) = delete;
+
+    size_type itemCount() const override;
+    size_type itemDimension() const override;
+    double errorProbability() const override;
+
+    /** @throws std::runtime_error if the query cannot be sent. */
+    std::future<bool> less(size_type i, size_type j, size_type k) override;
+
+    /** @throws std::runtime_error if the queries cannot be sent. */
+    void lessAsync(const ItemPair* pairs, const size_type* dims, size_type count,
+            std::future<bool>* results) override;
+
+    /** @throws std::runtime_error if the queries cannot be sent, or the process exits before answering them. */
+    void lessBatch(const ItemPair* pairs, const size_type* dims, size_type count, unsigned char* results) override;
+
+private:
+    /** Queries of one lessBatch() call that wait for their answers. */
+    struct Batch {
+        unsigned char* results;
+        size_type remaining;
+        bool failed;
+        std::condition_variable done;
+    };
+
+    /** Query in flight: its answer goes to the batch, or to the promise in promises_ if there is no batch. */
+    struct Slot {
+        std::uint64_t id;
+        bool used;
+        Batch* batch;
+        size_type index;
+    };
+
+    /**
+     * Send the queries; their answers go to the batch, or to the futures if the batch is nullptr.
+     * @throws std::runtime_error if the queries cannot be sent; their slots are released first.
+     */
+    void send(const ItemPair* pairs, const size_type* dims, size_type count, Batch* batch, std::future<bool>* futures);
+
+    /** Release the slot of a query; requires mutex_. */
+    void release(std::uint64_t slot);
+
+    /** Main loop of the reader thread; fails all pending queries when the process exits. */
+    void receive();
+
+    const size_type itemCount_;
+    const size_type itemDimension_;
+    const double errorProbability_;
+    ChildProcess process_;
+    /** Guards the slots, the promises and closed_; never held while writing, so that the reader can always take answers. */
+    std::mutex mutex_;
+    /** Serializes writes, so that the lines of concurrent calls are not interleaved. */
+    std::mutex writeMutex_;
+    /** Sequence number of the next query, in the high bits of its id. */
+    std::uint64_t nextSequence_;
+    std::vector<Slot> slots_;
+    std::vector<std::uint64_t> freeSlots_;
+    /** Promises of the queries of lessAsync(), by slot. */
+    std::unordered_map<std::uint64_t, std::promise<bool>> promises_;
+    /** Has the process stopped answering? */
+    bool closed_;
+    std::thread reader_;
+};
+
+#endif // JUDGE_HPP_
@@ -1,75 +1,262 @@
 #include <algorithm>
-#include <chrono>
-#include <fstream>
-#include <iostream>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
 
-#include "common.hpp"
+#include "nestedloops.hpp"
 
-/** Compute noisless skyline with simple nested loops. */
-void nestedloops(const Dataset& dataset, Skyline& skyline);
-
-/** Total number of performed comparisons. */
-static size_type comparisonCount = 0;
+template<typename T>
+void nestedloops(const BasicDataset<T>& dataset, Skyline& skyline, size_type& comparisonCount) {
+    skyline.clear();
+    comparisonCount = 0;
+    for (size_type i = 0; i < dataset.size(); i++) {
+        // Try to find item j that dominates item i.
+        auto j = findDominator(&dataset(i,0), dataset.data(), dataset.size(), dataset.ndims(), comparisonCount);
+        if (j == dataset.size()) {
+            skyline.push_back(i);
+        }
+    }
+}
 
-/** Main entry point. */
-int main(int argc, char** argv) {
-    if (argc != 5) {
-        std::cerr << "Usage: " << argv[0] << " input output size dimensions" << std::endl;
-        return EXIT_FAILURE;
+template<typename T>
+void nestedloopsColumnar(const BasicDataset<T>& dataset, Skyline& skyline, size_type& comparisonCount) {
+    skyline.clear();
+    comparisonCount = 0;
+    BasicColumnarDataset<T> columns(dataset);
+    for (size_type i = 0; i < dataset.size(); i++) {
+        // Try to find item j that dominates item i.
+        auto j = findDominator(&dataset(i,0), columns, 0, dataset.size(), comparisonCount);
+        if (j == dataset.size()) {
+            skyline.push_back(i);
+        }
     }
+}
 
-    auto input = argv[1];
-    auto output = argv[2];
-    auto size = datasetSizeParse(argv[3]);
-    auto dimensions = datasetSizeParse(argv[4]);
+template<typename T>
+void bnl(const BasicDataset<T>& dataset, Skyline& skyline, size_type& comparisonCount) {
+    skyline.clear();
+    comparisonCount = 0;
+    auto ndims = dataset.ndims();
+    // The window holds mutually non-dominated items, and a contiguous copy of their values;
+    // at the end it is the skyline.
+    Skyline& window = skyline;
+    std::vector<T> rows;
+    std::vector<unsigned char> dominated;
+    for (size_type i = 0; i < dataset.size(); i++) {
+        const T* item = &dataset(i,0);
+        if (findDominator(item, rows.data(), window.size(), ndims, comparisonCount) < window.size()) {
+            continue;
+        }
+        dominated.resize(window.size());
+        if (markDominated(item, rows.data(), window.size(), ndims, dominated.data(), comparisonCount) > 0) {
+            size_type kept = 0;
+            for (size_type w = 0; w < window.size(); w++) {
+                if (!dominated[w]) {
+                    window[kept] = window[w];
+                    std::copy_n(&rows[w * ndims], ndims, &rows[kept * ndims]);
+                    kept++;
+                }
+            }
+            window.resize(kept);
+            rows.resize(kept * ndims);
+        }
+        window.push_back(i);
+        rows.insert(rows.end(), item, item + ndims);
+    }
+}
 
-    Dataset dataset(size, dimensions);
-    datasetRead(dataset, input);
+template<typename T>
+void sfs(const BasicDataset<T>& dataset, Skyline& skyline, size_type& comparisonCount) {
+    skyline.clear();
+    comparisonCount = 0;
+    auto ndims = dataset.ndims();
 
-    Skyline skyline;
-    auto beforeTime = std::chrono::steady_clock::now();
-    nestedloops(dataset, skyline);
-    auto afterTime = std::chrono::steady_clock::now();
+    // Any dominating item has a greater or equal sum, and is lexicographically greater on ties.
+    std::vector<double> score(dataset.size(), 0);
+    for (size_type i = 0; i < dataset.size(); i++) {
+        for (size_type k = 0; k < ndims; k++) {
+            score[i] += static_cast<double>(dataset(i,k));
+        }
+    }
+    Skyline order(dataset.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_type i, size_type j) {
+        if (score[i] > score[j] || score[i] < score[j]) {
+            return score[i] > score[j];
+        }
+        return std::lexicographical_compare(&dataset(j,0), &dataset(j,0) + ndims, &dataset(i,0), &dataset(i,0) + ndims);
+    });
 
-    std::sort(skyline.begin(), skyline.end());
-    skylineWrite(skyline, output);
+    // Contiguous copy of the values of skyline items.
+    std::vector<T> rows;
+    for (auto i : order) {
+        const T* item = &dataset(i,0);
+        if (findDominator(item, rows.data(), skyline.size(), ndims, comparisonCount) == skyline.size()) {
+            skyline.push_back(i);
+            rows.insert(rows.end(), item, item + ndims);
+        }
+    }
+}
 
-    auto runningTime = std::chrono::duration_cast<std::chrono::milliseconds>(afterTime - beforeTime).count();
-    std::cout << runningTime << " " << comparisonCount << std::endl;
+/** Owning handle of a stdio file. */
+typedef std::unique_ptr<std::FILE, int(*)(std::FILE*)> FileHandle;
 
-    return EXIT_SUCCESS;
+/** Read exactly count bytes from the file. */
+static void externalRead(std::FILE* f, void* bytes, size_type count, const char* filename) {
+    if (std::fread(bytes, 1, count, f) != count) {
+        throw std::runtime_error(std::string("cannot read ") + filename);
+    }
 }
 
-void nestedloops(const Dataset& dataset, Skyline& skyline) {
+template<typename T>
+void bnlExternal(const char* filename, size_type size, size_type ndims, size_type memoryLimit,
+        Skyline& skyline, size_type& comparisonCount) {
     skyline.clear();
     comparisonCount = 0;
-    for (size_type i = 0; i < dataset.size(); i++) {
-        bool inSkyline = true;
-        // Try to find item j that dominates item i.
-        for (size_type j = 0; j < dataset.size(); j++) {
-            bool lt = false;
-            size_type k = 0;
-            for (; k < dataset.ndims(); k++) {
-                bool gt = dataset(i,k) > dataset(j,k);
-                comparisonCount++;
-                if (gt) {
-                    // Item i is not dominated by item j.
-                    break;
-                } else if (!lt) {
-                    // Item i is less than item j on at least one dimension.
-                    lt = dataset(i,k) < dataset(j,k);
-                    comparisonCount++;
+
+    // Records of temporary files are the 64-bit item index followed by its values,
+    // so the values stay aligned.
+    const size_type itemSize = ndims * sizeof(T);
+    const size_type recordSize = sizeof(std::uint64_t) + itemSize;
+    // A quarter of the memory is used to buffer the input, the rest holds the window.
+    const size_type blockSize = std::max<size_type>(memoryLimit / 4 / recordSize, 1);
+    const size_type itemBytes = itemSize + 2 * sizeof(size_type) + 2;
+    const size_type blockBytes = blockSize * recordSize;
+    const size_type capacity = (memoryLimit > blockBytes) ? (memoryLimit - blockBytes) / itemBytes : 0;
+    if (capacity == 0) {
+        throw std::runtime_error("memory limit of " + std::to_string(memoryLimit) + " bytes is too small");
+    }
+
+    // Window items with their contiguous values. The stamp is the number of records
+    // spilled in the pass before the item was added to the window; the item is output
+    // when it has been compared with all records read after it, which includes the spilled records of the next pass
+    // with positions from its stamp on. Items that survive a pass are carried to the next one,
+    // and stay at the front of the window in the order of their stamps.
+    Skyline window;
+    std::vector<T> rows;
+    std::vector<size_type> stamps;
+    std::vector<unsigned char> carried;
+    std::vector<unsigned char> dominated;
+    auto compact = [&](const std::vector<unsigned char>& removed) {
+        size_type kept = 0;
+        for (size_type w = 0; w < window.size(); w++) {
+            if (!removed[w]) {
+                window[kept] = window[w];
+                stamps[kept] = stamps[w];
+                carried[kept] = carried[w];
+                std::copy_n(&rows[w * ndims], ndims, &rows[kept * ndims]);
+                kept++;
+            }
+        }
+        window.resize(kept);
+        stamps.resize(kept);
+        carried.resize(kept);
+        rows.resize(kept * ndims);
+    };
+    auto release = [&](size_type count) {
+        skyline.insert(skyline.end(), window.begin(), window.begin() + static_cast<std::ptrdiff_t>(count));
+        window.erase(window.begin(), window.begin() + static_cast<std::ptrdiff_t>(count));
+        stamps.erase(stamps.begin(), stamps.begin() + static_cast<std::ptrdiff_t>(count));
+        carried.erase(carried.begin(), carried.begin() + static_cast<std::ptrdiff_t>(count));
+        rows.erase(rows.begin(), rows.begin() + static_cast<std::ptrdiff_t>(count * ndims));
+    };
+
+    FileHandle input(datasetOpen(filename, size, ndims, sizeof(T)), &std::fclose);
+    const char* inputName = filename;
+    size_type inputCount = size;
+    bool original = true;
+    // Words, so that the values of every record are aligned.
+    std::vector<std::uint64_t> storage((std::min(blockSize, std::max<size_type>(size, 1)) * recordSize + 7) / 8);
+    auto block = reinterpret_cast<unsigned char*>(storage.data());
+    while (true) {
+        FileHandle overflow(nullptr, &std::fclose);
+        size_type overflowCount = 0;
+        for (size_type begin = 0; begin < inputCount; begin += blockSize) {
+            auto count = std::min(blockSize, inputCount - begin);
+            externalRead(input.get(), block, count * (original ? itemSize : recordSize), inputName);
+            for (size_type r = 0; r < count; r++) {
+                size_type position = begin + r;
+                size_type index = position;
+                auto item = reinterpret_cast<const T*>(block + r * itemSize);
+                if (!original) {
+                    std::uint64_t stored;
+                    std::memcpy(&stored, block + r * recordSize, sizeof(stored));
+                    index = static_cast<size_type>(stored);
+                    item = reinterpret_cast<const T*>(block + r * recordSize + sizeof(stored));
                 }
+
+                size_type finished = 0;
+                while (finished < window.size() && carried[finished] && stamps[finished] <= position) {
+                    finished++;
+                }
+                if (finished > 0) {
+                    release(finished);
+                }
+
+                if (findDominator(item, rows.data(), window.size(), ndims, comparisonCount) < window.size()) {
+                    continue;
+                }
+                dominated.resize(window.size());
+                if (markDominated(item, rows.data(), window.size(), ndims, dominated.data(), comparisonCount) > 0) {
+                    compact(dominated);
+                }
+                if (window.size() < capacity) {
+                    window.push_back(index);
+                    rows.insert(rows.end(), item, item + ndims);
+                    stamps.push_back(overflowCount);
+                    carried.push_back(false);
+                    continue;
+                }
+                if (!overflow) {
+                    overflow.reset(std::tmpfile());
+                    if (!overflow) {
+                        throw std::runtime_error(std::string("cannot create temporary file: ") + std::strerror(errno));
+                    }
+                }
+                std::uint64_t stored = index;
+                if (std::fwrite(&stored, sizeof(stored), 1, overflow.get()) != 1
+                        || std::fwrite(item, sizeof(T), ndims, overflow.get()) != ndims) {
+                    throw std::runtime_error(std::string("cannot write temporary file: ") + std::strerror(errno));
+                }
+                overflowCount++;
             }
-            if (k == dataset.ndims() && lt) {
-                // Item i is less than item j on at least one dimension,
-                // and there are no dimensions on which item i is greater than item j.
-                inSkyline = false;
-                break;
+        }
+
+        // Items carried from the previous pass have now been compared with all records,
+        // and so have the items added before the first spilled record; the rest is carried to the next pass.
+        std::vector<unsigned char> finished(window.size());
+        for (size_type w = 0; w < window.size(); w++) {
+            finished[w] = carried[w] || stamps[w] == 0;
+            if (finished[w]) {
+                skyline.push_back(window[w]);
             }
+            carried[w] = true;
         }
-        if (inSkyline) {
-            skyline.push_back(i);
+        compact(finished);
+        if (overflowCount == 0) {
+            break;
         }
+        if (std::fflush(overflow.get()) != 0 || std::fseek(overflow.get(), 0, SEEK_SET) != 0) {
+            throw std::runtime_error(std::string("cannot rewind temporary file: ") + std::strerror(errno));
+        }
+        input = std::move(overflow);
+        inputName = "temporary file";
+        inputCount = overflowCount;
+        original = false;
     }
+    std::sort(skyline.begin(), skyline.end());
 }
+
+#define NESTEDLOOPS_INSTANTIATE(T) \
+    template void nestedloops<T>(const BasicDataset<T>&, Skyline&, size_type&); \
+    template void nestedloopsColumnar<T>(const BasicDataset<T>&, Skyline&, size_type&); \
+    template void bnl<T>(const BasicDataset<T>&, Skyline&, size_type&); \
+    template void sfs<T>(const BasicDataset<T>&, Skyline&, size_type&); \
+    template void bnlExternal<T>(const char*, size_type, size_type, size_type, Skyline&, size_type&);
+SKYLINE_VALUE_TYPES(NESTEDLOOPS_INSTANTIATE)
+#undef NESTEDLOOPS_INSTANTIATE
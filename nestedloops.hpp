@@ -0,0 +1,53 @@
+#ifndef NESTEDLOOPS_HPP_
+#define NESTEDLOOPS_HPP_
+
+#include "common.hpp"
+
+/*
+ * All algorithms set comparisonCount to the number of performed comparisons,
+ * and are instantiated for every type of values in SKYLINE_VALUE_TYPES.
+ */
+
+/** Compute noisless skyline with simple nested loops. */
+template<typename T>
+void nestedloops(const BasicDataset<T>& dataset, Skyline& skyline, size_type& comparisonCount);
+
+/** Compute noisless skyline with simple nested loops over a column-major copy of the dataset. */
+template<typename T>
+void nestedloopsColumnar(const BasicDataset<T>& dataset, Skyline& skyline, size_type& comparisonCount);
+
+/**
+ * Compute noisless skyline with block-nested-loops.
+ * Every item is compared only against the window of items that are not dominated so far;
+ * the window is kept entirely in memory, so a single pass is enough.
+ */
+template<typename T>
+void bnl(const BasicDataset<T>& dataset, Skyline& skyline, size_type& comparisonCount);
+
+/**
+ * Compute noisless skyline with sort-filter-skyline.
+ * Items are presorted by the sum of their values (ties are broken lexicographically),
+ * so that no item can be dominated by any item that follows it.
+ * Then every item is compared only against the skyline found so far, and the window never shrinks.
+ * Comparisons made by presorting are not counted.
+ */
+template<typename T>
+void sfs(const BasicDataset<T>& dataset, Skyline& skyline, size_type& comparisonCount);
+
+/**
+ * Compute noisless skyline of binary dataset file with multi-pass block-nested-loops,
+ * using at most about memoryLimit bytes for items, so the dataset may be larger than memory.
+ * The file is streamed in blocks; items that do not fit into the window are spilled to a temporary file,
+ * which is the input of the next pass.
+ * A window item is output as soon as it has been compared with every item that was read after it,
+ * so every pass reduces the input (Börzsönyi et al. "The Skyline Operator", ICDE '01).
+ * Skyline indices are sorted, so the result is the same as for the in-memory algorithms.
+ *
+ * @throws std::runtime_error if the file cannot be read, the temporary file cannot be written,
+ *         or the memory limit is too small for a single item.
+ */
+template<typename T>
+void bnlExternal(const char* filename, size_type size, size_type ndims, size_type memoryLimit,
+        Skyline& skyline, size_type& comparisonCount);
+
+#endif // NESTEDLOOPS_HPP_
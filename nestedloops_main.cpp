@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+
+#include "nestedloops.hpp"
+#include "skyline.hpp"
+
+/** Default memory limit of the external engine, in bytes. */
+static const size_type EXTERNAL_MEMORY_LIMIT = 256 << 20;
+
+/**
+ * Compute the skyline of the dataset file with values of type T,
+ * either with the external engine or with the algorithm of the options.
+ *
+ * @return running time in milliseconds, excluding the mapping of the file.
+ */
+template<typename T>
+static long long compute(const char* input, size_type size, size_type dimensions, bool external, size_type memoryLimit,
+        const SkylineOptions& options, Skyline& skyline, SkylineStats& stats);
+
+/** Main entry point. */
+int main(int argc, char** argv) {
+    const char* type = "double";
+    if (argc >= 3 && std::strcmp(argv[argc - 2], "--type") == 0) {
+        type = argv[argc - 1];
+        argc -= 2;
+    }
+    bool external = argc >= 6 && std::strcmp(argv[5], "external") == 0;
+    if (argc != 5 && argc != 6 && !(external && argc == 7)) {
+        std::cerr << "Usage: " << argv[0] << " input output size dimensions"
+                << " [nestedloops|columnar|bnl|sfs|external [memory_limit]] [--type double|float|int32|uint16]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto input = argv[1];
+    auto output = argv[2];
+    auto size = datasetSizeParse(argv[3]);
+    auto dimensions = datasetSizeParse(argv[4]);
+
+    SkylineOptions options;
+    size_type memoryLimit = EXTERNAL_MEMORY_LIMIT;
+    if (external) {
+        if (argc == 7) {
+            memoryLimit = datasetSizeParse(argv[6]);
+        }
+    } else if (argc == 6) {
+        const char* engines[] = {"nestedloops", "columnar", "bnl", "sfs"};
+        if (std::find_if(std::begin(engines), std::end(engines), [&](const char* engine) {
+                    return std::strcmp(argv[5], engine) == 0; }) == std::end(engines)) {
+            std::cerr << "Unknown engine: " << argv[5] << std::endl;
+            return EXIT_FAILURE;
+        }
+        options.algorithm = algorithmParse(argv[5]);
+    }
+
+    try {
+        Skyline skyline;
+        SkylineStats stats;
+        long long runningTime = 0;
+        switch (valueTypeParse(type)) {
+            case ValueType::float64: {
+                runningTime = compute<double>(input, size, dimensions, external, memoryLimit, options, skyline, stats);
+                break;
+            }
+            case ValueType::float32: {
+                runningTime = compute<float>(input, size, dimensions, external, memoryLimit, options, skyline, stats);
+                break;
+            }
+            case ValueType::int32: {
+                runningTime = compute<std::int32_t>(input, size, dimensions, external, memoryLimit, options,
+                        skyline, stats);
+                break;
+            }
+            case ValueType::uint16: {
+                runningTime = compute<std::uint16_t>(input, size, dimensions, external, memoryLimit, options,
+                        skyline, stats);
+                break;
+            }
+        }
+
+        skylineWrite(skyline, output);
+
+        std::cout << runningTime << " " << stats.comparisonCount << std::endl;
+
+        return EXIT_SUCCESS;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
+
+template<typename T>
+static long long compute(const char* input, size_type size, size_type dimensions, bool external, size_type memoryLimit,
+        const SkylineOptions& options, Skyline& skyline, SkylineStats& stats) {
+    auto beforeTime = std::chrono::steady_clock::now();
+    if (external) {
+        // The dataset is streamed from the file, and is never loaded as a whole.
+        bnlExternal<T>(input, size, dimensions, memoryLimit, skyline, stats.comparisonCount);
+    } else {
+        auto dataset = datasetMap<T>(input, size, dimensions, MapHint::sequential);
+        beforeTime = std::chrono::steady_clock::now();
+        skylineCompute(dataset, options, skyline, stats);
+    }
+    auto afterTime = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(afterTime - beforeTime).count();
+}
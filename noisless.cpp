@@ -1,119 +1,193 @@
 #include <algorithm>
-#include <chrono>
-#include <fstream>
-#include <iostream>
-#include <unordered_set>
+#include <atomic>
+#include <numeric>
 
-#include "common.hpp"
+#include "noisless.hpp"
 
-/** Skyline indices stored in a hash table for fast removals. */
-using SkylineSet = std::unordered_set<size_type>;
+/*
+ * Helpers are specialized for D dimensions, or generic if D is 0 (see SKYLINE_FIXED_DIMS).
+ */
 
-/** Find maximal lexicographical element. */
-size_type maxLex(const Dataset& dataset, const SkylineSet& items);
-
-/** Remove items that are dominated by maximum. */
-void removeDominated(size_type max, const Dataset& dataset, SkylineSet& items);
-
-/** Compute noisless skyline with output-sensitive algorithm. */
-void noisless(const Dataset& dataset, Skyline& skyline);
+/** Assuming lexicographical ordering of dimensions, is item i greater than item j? */
+template<size_type D, typename T>
+bool greaterLex(const BasicDataset<T>& dataset, size_type i, size_type j, size_type& comparisons);
 
-/** Total number of performed comparisons. */
-static size_type comparisonCount = 0;
+/** Find maximal lexicographical element. */
+template<size_type D, typename T>
+size_type maxLex(const BasicDataset<T>& dataset, const Skyline& items, size_type& comparisons);
+
+/**
+ * Remove the maximum and items that are dominated by it, compacting the remaining items in place,
+ * and find the maximal lexicographical element among the remaining items in the same pass.
+ *
+ * @return the maximal remaining item, or NULL_SKYLINE if no items remain.
+ */
+template<size_type D, typename T>
+size_type removeDominatedMaxLex(size_type max, const BasicDataset<T>& dataset, Skyline& items, size_type& comparisons);
+
+/**
+ * Compute noisless skyline of the specified items with output-sensitive algorithm.
+ * The items are used as the candidate pool and are consumed by the computation.
+ */
+template<typename T>
+void noislessItems(const BasicDataset<T>& dataset, Skyline& items, Skyline& skyline, size_type& comparisons);
+
+/** Same as noislessItems(). */
+template<size_type D, typename T>
+void noislessItemsFixed(const BasicDataset<T>& dataset, Skyline& items, Skyline& skyline, size_type& comparisons);
+
+template<size_type D, typename T>
+bool greaterLex(const BasicDataset<T>& dataset, size_type i, size_type j, size_type& comparisons) {
+    for (size_type k = 0; k < fixedDims<D>(dataset.ndims()); k++) {
+        bool gt = dataset(i,k) > dataset(j,k);
+        comparisons++;
+        if (gt) {
+            return true;
+        }
 
-/** Main entry point. */
-int main(int argc, char** argv) {
-    if (argc != 5) {
-        std::cerr << "Usage: " << argv[0] << " input output size dimensions" << std::endl;
-        return EXIT_FAILURE;
+        bool lt = dataset(i,k) < dataset(j,k);
+        comparisons++;
+        if (lt) {
+            return false;
+        }
     }
-
-    auto input = argv[1];
-    auto output = argv[2];
-    auto size = datasetSizeParse(argv[3]);
-    auto dimensions = datasetSizeParse(argv[4]);
-
-    Dataset dataset(size, dimensions);
-    datasetRead(dataset, input);
-
-    Skyline skyline;
-    auto beforeTime = std::chrono::steady_clock::now();
-    noisless(dataset, skyline);
-    auto afterTime = std::chrono::steady_clock::now();
-
-    std::sort(skyline.begin(), skyline.end());
-    skylineWrite(skyline, output);
-
-    auto runningTime = std::chrono::duration_cast<std::chrono::milliseconds>(afterTime - beforeTime).count();
-    std::cout << runningTime << " " << comparisonCount << std::endl;
-
-    return EXIT_SUCCESS;
+    return false;
 }
 
-size_type maxLex(const Dataset& dataset, const SkylineSet& items) {
-    auto max = *items.cbegin();
+template<size_type D, typename T>
+size_type maxLex(const BasicDataset<T>& dataset, const Skyline& items, size_type& comparisons) {
+    auto max = items.front();
+    for (auto item : items) {
+        if (item != max && greaterLex<D>(dataset, item, max, comparisons)) {
+            max = item;
+        }
+    }
+    return max;
+}
 
+template<size_type D, typename T>
+size_type removeDominatedMaxLex(size_type max, const BasicDataset<T>& dataset, Skyline& items, size_type& comparisons) {
+    auto dominated = dominatedByKernel<T>(dataset.ndims());
+    size_type next = NULL_SKYLINE;
+    size_type kept = 0;
     for (auto item : items) {
-        if (item == max) {
+        if (item == max || dominated(&dataset(item,0), &dataset(max,0), dataset.ndims(), comparisons)) {
             continue;
         }
-
-        for (size_type k = 0; k < dataset.ndims(); k++) {
-            bool gt = dataset(item,k) > dataset(max,k);
-            comparisonCount++;
-            if (gt) {
-                max = item;
-                break;
-            }
-
-            bool lt = dataset(item,k) < dataset(max,k);
-            comparisonCount++;
-            if (lt) {
-                break;
-            }
+        items[kept++] = item;
+        if (next == NULL_SKYLINE || greaterLex<D>(dataset, item, next, comparisons)) {
+            next = item;
         }
     }
-
-    return max;
+    items.resize(kept);
+    return next;
 }
 
-void removeDominated(size_type max, const Dataset& dataset, SkylineSet& items) {
-    auto it = items.begin();
-    while (it != items.end()) {
-        bool lt = false;
-        size_type k = 0;
-        for (; k < dataset.ndims(); k++) {
-            bool gt = dataset(*it,k) > dataset(max,k);
-            comparisonCount++;
-            if (gt) {
-                break;
-            } else if (!lt) {
-                lt = dataset(*it,k) < dataset(max,k);
-                comparisonCount++;
-            }
+template<typename T>
+void noislessItems(const BasicDataset<T>& dataset, Skyline& items, Skyline& skyline, size_type& comparisons) {
+    switch (dataset.ndims()) {
+#define NOISLESS_FIXED(D) \
+        case D: { \
+            noislessItemsFixed<D>(dataset, items, skyline, comparisons); \
+            break; \
         }
-
-        if (k == dataset.ndims() && lt) {
-            it = items.erase(it);
-        } else {
-            it++;
+        SKYLINE_FIXED_DIMS(NOISLESS_FIXED)
+#undef NOISLESS_FIXED
+        default: {
+            noislessItemsFixed<0>(dataset, items, skyline, comparisons);
+            break;
         }
     }
 }
 
-void noisless(const Dataset& dataset, Skyline& skyline) {
+template<size_type D, typename T>
+void noislessItemsFixed(const BasicDataset<T>& dataset, Skyline& items, Skyline& skyline, size_type& comparisons) {
     skyline.clear();
+    if (items.empty()) {
+        return;
+    }
+    // The lexicographical maximum of the items that are not dominated yet is a skyline item.
+    size_type max = maxLex<D>(dataset, items, comparisons);
+    while (max != NULL_SKYLINE) {
+        skyline.push_back(max);
+        max = removeDominatedMaxLex<D>(max, dataset, items, comparisons);
+    }
+}
+
+template<typename T>
+void noisless(const BasicDataset<T>& dataset, Skyline& skyline, size_type& comparisonCount) {
     comparisonCount = 0;
+    Skyline notDominated(dataset.size());
+    std::iota(notDominated.begin(), notDominated.end(), 0);
+    noislessItems(dataset, notDominated, skyline, comparisonCount);
+}
 
-    SkylineSet notDominated;
-    for (size_type i = 0; i < dataset.size(); i++) {
-        notDominated.insert(i);
+template<typename T>
+void noislessParallel(const BasicDataset<T>& dataset, ThreadPool& pool, Skyline& skyline, size_type& comparisonCount) {
+    skyline.clear();
+    comparisonCount = 0;
+    if (dataset.size() == 0) {
+        return;
     }
+    auto ndims = dataset.ndims();
+    std::atomic<size_type> comparisons(0);
+
+    // Several chunks per thread, so that uneven local skylines are balanced by work stealing.
+    size_type chunkCount = std::min(dataset.size(), 4 * pool.size());
+    std::vector<Skyline> partial(chunkCount);
+    pool.parallelFor(0, chunkCount, [&](size_type c) {
+        Skyline items(dataset.size() * (c + 1) / chunkCount - dataset.size() * c / chunkCount);
+        std::iota(items.begin(), items.end(), dataset.size() * c / chunkCount);
+        size_type local = 0;
+        noislessItems(dataset, items, partial[c], local);
+        comparisons += local;
+    });
+
+    while (partial.size() > 1) {
+        // Partial skylines 2t and 2t+1 are merged; the last one is left as is if their number is odd.
+        size_type paired = partial.size() / 2 * 2;
+        std::vector<size_type> offsets(paired + 1, 0);
+        for (size_type p = 0; p < paired; p++) {
+            offsets[p + 1] = offsets[p] + partial[p].size();
+        }
 
-    while (!notDominated.empty()) {
-        size_type max = maxLex(dataset, notDominated);
-        notDominated.erase(max);
-        removeDominated(max, dataset, notDominated);
-        skyline.push_back(max);
+        // Contiguous copies of the values of partial skyline items, for one-vs-many dominance tests.
+        std::vector<std::vector<T>> rows(paired);
+        pool.parallelFor(0, paired, [&](size_type p) {
+            rows[p].reserve(partial[p].size() * ndims);
+            for (auto i : partial[p]) {
+                rows[p].insert(rows[p].end(), &dataset(i,0), &dataset(i,0) + ndims);
+            }
+        });
+
+        std::vector<unsigned char> dominated(offsets.back());
+        pool.parallelFor(0, offsets.back(), [&](size_type x) {
+            size_type p = static_cast<size_type>(std::upper_bound(offsets.begin(), offsets.end(), x) - offsets.begin()) - 1;
+            size_type other = p ^ 1;
+            size_type local = 0;
+            auto item = rows[p].data() + (x - offsets[p]) * ndims;
+            dominated[x] = findDominator(item, rows[other].data(), partial[other].size(), ndims, local)
+                    < partial[other].size();
+            comparisons += local;
+        });
+
+        std::vector<Skyline> merged((partial.size() + 1) / 2);
+        for (size_type p = 0; p < partial.size(); p++) {
+            for (size_type r = 0; r < partial[p].size(); r++) {
+                if (p >= paired || !dominated[offsets[p] + r]) {
+                    merged[p / 2].push_back(partial[p][r]);
+                }
+            }
+        }
+        partial.swap(merged);
     }
+
+    skyline.swap(partial[0]);
+    comparisonCount = comparisons;
 }
+
+#define NOISLESS_INSTANTIATE(T) \
+    template void noisless<T>(const BasicDataset<T>&, Skyline&, size_type&); \
+    template void noislessParallel<T>(const BasicDataset<T>&, ThreadPool&, Skyline&, size_type&);
+SKYLINE_VALUE_TYPES(NOISLESS_INSTANTIATE)
+#undef NOISLESS_INSTANTIATE
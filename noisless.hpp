@@ -0,0 +1,28 @@
+#ifndef NOISLESS_HPP_
+#define NOISLESS_HPP_
+
+#include "common.hpp"
+#include "threadpool.hpp"
+
+/*
+ * Both algorithms are instantiated for every type of values in SKYLINE_VALUE_TYPES.
+ */
+
+/**
+ * Compute noisless skyline with output-sensitive algorithm.
+ * Sets comparisonCount to the number of performed comparisons.
+ */
+template<typename T>
+void noisless(const BasicDataset<T>& dataset, Skyline& skyline, size_type& comparisonCount);
+
+/**
+ * Compute noisless skyline in parallel by divide and conquer.
+ * Local skylines of contiguous chunks of the dataset are computed with noislessItems(),
+ * then partial skylines are merged pairwise, keeping the items of each partial skyline
+ * that are not dominated by any item of the other one.
+ * Sets comparisonCount to the number of performed comparisons.
+ */
+template<typename T>
+void noislessParallel(const BasicDataset<T>& dataset, ThreadPool& pool, Skyline& skyline, size_type& comparisonCount);
+
+#endif // NOISLESS_HPP_
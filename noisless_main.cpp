@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "skyline.hpp"
+
+/**
+ * Compute the skyline of the dataset file with values of type T.
+ *
+ * @return running time in milliseconds, excluding the mapping of the file.
+ */
+template<typename T>
+static long long compute(const char* input, size_type size, size_type dimensions,
+        const SkylineOptions& options, Skyline& skyline, SkylineStats& stats);
+
+/** Main entry point. */
+int main(int argc, char** argv) {
+    const char* type = "double";
+    if (argc >= 3 && std::strcmp(argv[argc - 2], "--type") == 0) {
+        type = argv[argc - 1];
+        argc -= 2;
+    }
+    if (argc != 5 && argc != 6) {
+        std::cerr << "Usage: " << argv[0] << " input output size dimensions [threads|bskytree]"
+                << " [--type double|float|int32|uint16]" << std::endl;
+        std::cerr << "With threads (0 for all hardware threads), the parallel algorithm is used;"
+                << " with bskytree, the pivot-partitioning engine is used." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto input = argv[1];
+    auto output = argv[2];
+    auto partitioned = argc == 6 && std::strcmp(argv[5], "bskytree") == 0;
+    auto parallel = argc == 6 && !partitioned;
+
+    try {
+        auto size = datasetSizeParse(argv[3]);
+        auto dimensions = datasetSizeParse(argv[4]);
+        auto threads = parallel ? datasetSizeParse(argv[5]) : 1;
+        ThreadPool pool(threads);
+        SkylineOptions options;
+        options.algorithm = partitioned ? Algorithm::bskytree : Algorithm::noisless;
+        options.threadPool = parallel ? &pool : nullptr;
+        Skyline skyline;
+        SkylineStats stats;
+        long long runningTime = 0;
+        switch (valueTypeParse(type)) {
+            case ValueType::float64: {
+                runningTime = compute<double>(input, size, dimensions, options, skyline, stats);
+                break;
+            }
+            case ValueType::float32: {
+                runningTime = compute<float>(input, size, dimensions, options, skyline, stats);
+                break;
+            }
+            case ValueType::int32: {
+                runningTime = compute<std::int32_t>(input, size, dimensions, options, skyline, stats);
+                break;
+            }
+            case ValueType::uint16: {
+                runningTime = compute<std::uint16_t>(input, size, dimensions, options, skyline, stats);
+                break;
+            }
+        }
+
+        skylineWrite(skyline, output);
+
+        std::cout << runningTime << " " << stats.comparisonCount << std::endl;
+
+        return EXIT_SUCCESS;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
+
+template<typename T>
+static long long compute(const char* input, size_type size, size_type dimensions,
+        const SkylineOptions& options, Skyline& skyline, SkylineStats& stats) {
+    auto dataset = datasetMap<T>(input, size, dimensions, MapHint::sequential);
+    auto beforeTime = std::chrono::steady_clock::now();
+    skylineCompute(dataset, options, skyline, stats);
+    auto afterTime = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(afterTime - beforeTime).count();
+}
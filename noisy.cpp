@@ -1,14 +1,19 @@
 #include <algorithm>
+#include <atomic>
 #include <chrono>
-#include <fstream>
-#include <iostream>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <functional>
 #include <limits>
+#include <memory>
 #include <numeric>
-#include <random>
+#include <ostream>
 #include <stdexcept>
-#include <string>
 
-#include "common.hpp"
+#include "noisy.hpp"
+#include "stats.hpp"
 
 /* Ternary logic. */
 enum class ternary {
@@ -17,95 +22,202 @@ enum class ternary {
     true_ = 2,
 };
 
-/** "Not found" skyline index. */
-const size_type NULL_SKYLINE = std::numeric_limits<size_type>::max();
+/** Options and statistics of one computation of noisy(); shared by all functions that it calls. */
+struct NoisyContext {
+    const NoisyOptions& options;
+    NoisyStats& stats;
+};
 
 /**
- * This class emulates queries to independent noisy oracles.
- * It holds the real data and answers questions
- * "Is i-th item is less than j-th item on dimension k?"
- * with some predefined error probability.
- * Also, it keeps track of number of such queries.
+ * Skyline items found so far by skySample(), together with the progress of dominance checks against them.
  *
- * Derived oracles should either this class
- * or other derived oracles as a basis.
+ * The skyline only grows during skySample(), so once an item is known not to be dominated
+ * by the first m skyline items, only the following skyline items have to be checked,
+ * and once an item is known to be dominated, it stays dominated.
+ * Verdicts are reused only if all checks behind them were made with the same or smaller tolerance,
+ * so that every reused verdict satisfies the requested error probability.
  *
- * After construction, there is no way to retreive
- * the dataset for which the skyline should be computed.
- * This ensures that derived oracles won't use
- * the numerical values in the dataset directly.
+ * Optionally, a prefix of the skyline items is also kept sorted along each dimension,
+ * so that dominatedByAnySorted() can rule out most of them with binary searches.
+ * The index is not extended by push(): index() extends it before a tournament,
+ * and only if the searches it enables are expected to save more oracle calls than the insertions cost.
  */
-class Oracle {
+class DominanceState {
 public:
     /**
-     * Construct the oracle.
+     * Construct the empty skyline.
      *
-     * @param dataset The dataset to use; must not be empty,
-     *     all items in the dataset must have the same size.
-     * @param errorProbability Ratio of correctness for queries to this oracle;
-     *     must be in the range [0.0; 0.5).
+     * @param itemCount Total number of items in the dataset.
+     * @param itemDimension Dimension of every item in the dataset.
+     * @param sorted Whether to keep the skyline items sorted along each dimension.
      */
-    Oracle(const Dataset& dataset, double errorProbability);
+    DominanceState(size_type itemCount, size_type itemDimension, bool sorted);
 
     /**
-     * Total number of items in the dataset.
+     * Skyline items found so far.
      */
-    size_type itemCount() const;
+    const Skyline& skyline() const;
 
     /**
-     * Dimension of every item in the underlying dataset.
+     * Append the item to the skyline.
      */
-    size_type itemDimension() const;
+    void push(size_type item);
 
     /**
-     * Probability of returning the wrong result in compare().
+     * If the skyline is sorted, decide whether to insert the skyline items that are not in the orderings yet,
+     * before a sample with the specified tolerance, and insert them if so.
+     * The insertions take half of the tolerance, split between the binary searches
+     * of every inserted item along every dimension, so that misordered items are charged to the sample.
+     * Orderings made with a larger tolerance are dropped first.
+     *
+     * @return the tolerance left for the tournament of the sample.
      */
-    double errorProbability() const;
+    double index(NoisyContext& context, Oracle& oracle, double tolerance);
 
-    /**
-     * Is item i is less than item j on a dimension k?
-     * The result is erroneous with probability errorProbability()
-     * (i.e. correct with probability 1 - errorProbability()).
-     */
-    bool less(size_type i, size_type j, size_type k);
+private:
+    friend bool dominatedByAny(NoisyContext& context, Oracle& oracle, size_type i, DominanceState& c, double tolerance);
+    friend bool dominatedByAnySorted(NoisyContext& context, Oracle& oracle, size_type i, const DominanceState& c, double tolerance);
+    friend bool dominatedByAnyBatched(NoisyContext& context, Oracle& oracle, size_type i, DominanceState& c, double tolerance);
 
     /**
-     * The total number of comparisons made (that is, number of calls to compare()).
+     * Expected number of skyline items that a linear check of item i with the specified tolerance goes through.
+     * Verdicts made with a larger tolerance are checked again from the start,
+     * and an item that was found dominated is expected to be found dominated by the same skyline item.
      */
-    size_type comparisonCount() const;
+    size_type expectedScan(size_type i, double tolerance) const;
 
-private:
-    const Dataset dataset_;
-    const double errorProbability_;
-    std::mt19937 rng_;
-    size_type comparisonCount_;
+    Skyline skyline_;
+    const bool sorted_;
+    /** The first indexed_ skyline items in the ascending order along each dimension. */
+    std::vector<Skyline> orders_;
+    /** Position of each indexed skyline item (by its position in skyline_) in the order along each dimension. */
+    std::vector<std::vector<size_type>> ranks_;
+    /** Number of skyline items in the orderings. */
+    size_type indexed_;
+    /** Tolerance of the sample that last extended the orderings. */
+    double indexTolerance_;
+    /** Number of skyline items each item has been checked against. */
+    std::vector<size_type> checked_;
+    /** Largest tolerance used in the checks of each item. */
+    std::vector<double> tolerance_;
+    /** Has each item been found to be dominated? */
+    std::vector<unsigned char> dominated_;
 };
 
 /**
  * Is item i is less than item j on a dimension k?
+ * The result is wrong with probability at most tolerance;
+ * the oracle is queried as many times as required by the comparison mode in the options.
  *
  * To check if (i_k < j_k), use less(i, j, k, tolerance).
  * To check if (i_k > j_k), use less(j, i, k, tolerance).
  * To check if (i_k <= j_k), use !less(j, i, k, tolerance).
  * To check if (i_k >= j_k), use !less(i, j, k, tolerance).
  */
-bool less(Oracle& oracle, size_type i, size_type j, size_type k, double tolerance);
+bool less(NoisyContext& context, Oracle& oracle, size_type i, size_type j, size_type k, double tolerance);
+
+/**
+ * Same as less(), using recursive majority of 3 votes with doubled tolerance.
+ */
+bool lessMajority(Oracle& oracle, size_type i, size_type j, size_type k, double tolerance);
+
+/**
+ * Is item pairs[q].i less than item pairs[q].j on dimension dims[q], for each q in [0; count)?
+ * Each result is wrong with probability at most tolerance, and takes the same number of oracle calls as less(),
+ * but the oracle calls of all comparisons are made in batches, so that a judge answers them concurrently.
+ */
+void lessMany(NoisyContext& context, Oracle& oracle, const ItemPair* pairs, const size_type* dims, size_type count,
+        double tolerance, unsigned char* results);
+
+/**
+ * Recursive majority of lessMajority() for each comparison, with the votes of all comparisons batched.
+ *
+ * @param level Depth of the recursion; every level has its own buffers.
+ */
+void lessMajorityMany(Oracle& oracle, const ItemPair* pairs, const size_type* dims, size_type count,
+        double tolerance, unsigned char* results, size_type level);
+
+/** Sequential test of lessSequential() for each comparison, with the votes of all comparisons batched. */
+void lessSequentialMany(Oracle& oracle, const ItemPair* pairs, const size_type* dims, size_type count,
+        double tolerance, unsigned char* results);
+
+/**
+ * Expected number of oracle calls of one less() with the specified tolerance;
+ * used to choose between linear scans and binary searches, which make comparisons with different tolerances.
+ */
+double queryCost(const NoisyContext& context, const Oracle& oracle, double tolerance);
+
+/**
+ * Same as less(), using the sequential probability ratio test.
+ *
+ * Each answer moves a random walk one step up ("less") or down ("not less"),
+ * and the oracle is queried until the walk reaches +A or -A.
+ * The walk moves in the wrong direction with probability p = errorProbability(),
+ * so by the gambler's ruin formula it ends on the wrong side with probability 1 / (1 + r^A),
+ * where r = (1 - p) / p. The smallest A with r^A >= (1 - tolerance) / tolerance is used.
+ */
+bool lessSequential(Oracle& oracle, size_type i, size_type j, size_type k, double tolerance);
 
 /**
  * Assuming lexicographical ordering of dimensions, is item i is less than item j?
  */
-bool lessLex(Oracle& oracle, size_type i, size_type j, double tolerance);
+bool lessLex(NoisyContext& context, Oracle& oracle, size_type i, size_type j, double tolerance);
+
+/** Same as lessLex(), specialized for D dimensions, or generic if D is 0 (see SKYLINE_FIXED_DIMS). */
+template<size_type D>
+bool lessLexFixed(NoisyContext& context, Oracle& oracle, size_type i, size_type j, double tolerance);
 
 /**
  * Is item i dominated by item j?
  */
-bool dominatedBy(Oracle& oracle, size_type i, size_type j, double tolerance);
+bool dominatedBy(NoisyContext& context, Oracle& oracle, size_type i, size_type j, double tolerance);
+
+/** Same as dominatedBy(), specialized for D dimensions, or generic if D is 0. */
+template<size_type D>
+bool dominatedByFixed(NoisyContext& context, Oracle& oracle, size_type i, size_type j, double tolerance);
 
 /**
  * Is item i dominated by any of the items j in c?
  */
-// TODO: Implement a variant of dominance check when the ordering of c is known along each dimension.
-bool dominatedByAny(Oracle& oracle, size_type i, const Skyline& c, double tolerance);
+bool dominatedByAny(NoisyContext& context, Oracle& oracle, size_type i, const Skyline& c, double tolerance);
+
+/**
+ * Is item i dominated by any of the items in c?
+ * Checks only the items of c that were added after the previous check of item i,
+ * unless the previous checks were made with a larger tolerance.
+ * If the indexed items of c to check are expected to cost more oracle calls than binary searches,
+ * uses dominatedByAnySorted() for them instead.
+ */
+bool dominatedByAny(NoisyContext& context, Oracle& oracle, size_type i, DominanceState& c, double tolerance);
+
+/**
+ * Linear part of dominatedByAny() for an oracle backed by a judge:
+ * the comparisons along every dimension with several skyline items are made at once with lessMany(),
+ * trading the comparisons that the scan would have skipped for fewer round trips to the judge.
+ */
+bool dominatedByAnyBatched(NoisyContext& context, Oracle& oracle, size_type i, DominanceState& c, double tolerance);
+
+/**
+ * Position of the first item in the order along dimension k that is not less than item i on this dimension.
+ * The binary search is wrong with probability at most tolerance.
+ */
+size_type lowerBound(NoisyContext& context, Oracle& oracle, const Skyline& order, size_type i, size_type k, double tolerance);
+
+/**
+ * Expected number of oracle calls of lowerBound() with the specified tolerance
+ * along every dimension, in orderings of count items.
+ */
+double searchCost(const NoisyContext& context, const Oracle& oracle, size_type count, double tolerance);
+
+/**
+ * Is item i dominated by any of the indexed items of c that it has not been checked against yet?
+ *
+ * An item j can dominate item i only if it is not less than item i on every dimension,
+ * that is, only if it is in the suffix of each ordering that starts at lowerBound().
+ * Only the items in all suffixes are checked with dominatedBy(),
+ * so most of c is ruled out with O(d log |c|) comparisons.
+ */
+bool dominatedByAnySorted(NoisyContext& context, Oracle& oracle, size_type i, const DominanceState& c, double tolerance);
 
 /**
  * Predicate for lexicographic non-dominance total order; used in maxLexNotDominated().
@@ -114,14 +226,15 @@ bool dominatedByAny(Oracle& oracle, size_type i, const Skyline& c, double tolera
  *         ternary::false_ if either both items are not dominated and i > j, or i is not domianted and j is;
  *         ternary::unknown if both items are dominated.
  */
-ternary lessLexNotDominated(Oracle& oracle, size_type i, size_type j, const Skyline& c, double tolerance);
+ternary lessLexNotDominated(NoisyContext& context, Oracle& oracle, size_type i, size_type j, DominanceState& c, double tolerance);
 
 /**
- * The index of the maximum item between item i and item j that is not dominated by any item in c.
+ * The index of the maximum item between item i and item j that is not dominated by any item in c;
+ * either of them may be NULL_SKYLINE, which stands for a dominated item.
  *
  * @return index of the maximal item between i and j, or NULL_SKYLINE if both i and j are dominated.
  */
-size_type max2LexNotDominated(Oracle& oracle, size_type i, size_type j, const Skyline& c, double tolerance);
+size_type max2LexNotDominated(NoisyContext& context, Oracle& oracle, size_type i, size_type j, DominanceState& c, double tolerance);
 
 /**
  * The index of the maximum item among the n items whose indices are in s, from the specified offset,
@@ -132,64 +245,102 @@ size_type max2LexNotDominated(Oracle& oracle, size_type i, size_type j, const Sk
  *
  * @return index of the maximal item among s, or NULL_SKYLINE if all of them are domianted.
  */
-size_type max4LexNotDominated(Oracle& oracle, const Skyline& s,
-        size_type offset, size_type n, const Skyline& c, double tolerance);
+size_type max4LexNotDominated(NoisyContext& context, Oracle& oracle, const Skyline& s,
+        size_type offset, size_type n, DominanceState& c, double tolerance);
+
+/**
+ * Buffers of maxLexNotDominated(), owned by one call of skySample() and reused by all its samples,
+ * so that the tournament does not allocate after they are constructed.
+ */
+struct Tournament {
+    /** Allocate the buffers for a tournament among itemCount items. */
+    explicit Tournament(size_type itemCount);
+
+    /** Winners of the groups of the current level and of the previous one. */
+    Skyline winners[2];
+    /** Forked oracles of the groups of the current level. */
+    std::vector<Oracle> oracles;
+};
 
 /**
  * The index of the maximum item among the items whose indices are in s that is not dominated by any item in c.
+ * Levels of the tournament alternate between the two buffers of winners in t.
  *
  * @return index of the maximal item among s, or NULL_SKYLINE if all of them are domianted.
  */
-size_type maxLexNotDominated(Oracle& oracle, const Skyline& s, const Skyline& c, double tolerance);
+size_type maxLexNotDominated(NoisyContext& context, Oracle& oracle, const Skyline& s, DominanceState& c, double tolerance,
+        Tournament& t);
 
 /**
- * Sample the items in s for skyline items at most n times.
+ * Sample the items in s for skyline items, until c holds n of them or no item remains.
+ * Skyline items already in c are kept; the tolerance is split between all n samples,
+ * and the shares of the kept items are left to skyVerify().
  */
-void skySample(Oracle& oracle, const Skyline& s, size_type n, double tolerance, Skyline& result);
+void skySample(NoisyContext& context, Oracle& oracle, const Skyline& s, size_type n, double tolerance, DominanceState& c);
 
 /**
- * Compute skyline from the entire dataset.
+ * Check every skyline item in c again for dominance by the items in s, with the specified tolerance,
+ * as if it was sampled again, and start c over from the items that are not dominated if any item is.
+ *
+ * Items that are not dominated by any item are skyline items, whatever their order:
+ * an item that the next tournament picks is then not dominated either,
+ * since its dominators are lexicographically greater, and not dominated by c.
  */
-void noisy(Oracle& oracle, double tolerance, Skyline& result);
-
-/** Main entry point. */
-int main(int argc, char** argv) {
-    if (argc != 7) {
-        std::cerr << "Usage: " << argv[0] << " input output size dimensions tolerance error_probability" << std::endl;
-        return EXIT_FAILURE;
-    }
-
-    auto input = argv[1];
-    auto output = argv[2];
-    auto size = datasetSizeParse(argv[3]);
-    auto dimensions = datasetSizeParse(argv[4]);
-    auto tolerance = std::stod(argv[5]);
-    auto errorProbability = std::stod(argv[6]);
+void skyVerify(NoisyContext& context, Oracle& oracle, const Skyline& s, double tolerance,
+        std::unique_ptr<DominanceState>& c);
 
-    Dataset dataset(size, dimensions);
-    datasetRead(dataset, input);
+#ifdef SKYLINE_STATS
+/** Write phase statistics as JSON object. */
+static void phaseStatsWrite(std::ostream& out, const PhaseStats& stats) {
+    out << "{\"calls\": " << stats.calls << ", \"oracle_calls\": " << stats.queries
+            << ", \"time_ms\": " << static_cast<double>(stats.nanoseconds) / 1e6 << "}";
+}
+#endif
 
-    Oracle oracle(dataset, errorProbability);
-    Skyline skyline;
-    auto beforeTime = std::chrono::steady_clock::now();
-    noisy(oracle, tolerance, skyline);
-    auto afterTime = std::chrono::steady_clock::now();
+NoisyOptions::NoisyOptions()
+        : comparisonMode(ComparisonMode::majority), threadPool(nullptr), sortedIndex(false), reusePrefix(false) {
+}
 
-    std::sort(skyline.begin(), skyline.end());
-    skylineWrite(skyline, output);
+NoisyStats::NoisyStats()
+        : comparisonCount(0) {
+}
 
-    auto runningTime = std::chrono::duration_cast<std::chrono::milliseconds>(afterTime - beforeTime).count();
-    std::cout << runningTime << " " << oracle.comparisonCount() << std::endl;
+void noisyStatsWrite(std::ostream& out, const NoisyStats& stats) {
+    out << "{\"comparisons\": " << stats.comparisonCount << ", \"phases\": {";
+#ifdef SKYLINE_STATS
+    out << "\"lessLex\": ";
+    phaseStatsWrite(out, stats.lessLex);
+    out << ", \"dominatedByAny\": ";
+    phaseStatsWrite(out, stats.dominatedByAny);
+    out << ", \"dominatedByAnySorted\": ";
+    phaseStatsWrite(out, stats.dominatedByAnySorted);
+    out << ", \"push\": ";
+    phaseStatsWrite(out, stats.push);
+    out << ", \"maxLexNotDominated\": ";
+    phaseStatsWrite(out, stats.maxLexNotDominated);
+#endif
+    out << "}, \"rounds\": [";
+    for (size_type r = 0; r < stats.rounds.size(); r++) {
+        const auto& round = stats.rounds[r];
+        out << (r > 0 ? ", " : "") << "{\"samples\": " << round.samples << ", \"tolerance\": " << round.tolerance
+                << ", \"skyline_size\": " << round.skylineSize << ", \"oracle_calls\": " << round.queries
+                << ", \"time_ms\": " << static_cast<double>(round.nanoseconds) / 1e6 << "}";
+    }
+    out << "]}";
+}
 
-    return EXIT_SUCCESS;
+Oracle::Oracle(const Dataset& dataset, double errorProbability, std::uint64_t seed)
+        : dataset_(dataset), errorProbability_(errorProbability), seed_(seed),
+          stream_(0), forkCount_(0), comparisonCount_(0) {
 }
 
-Oracle::Oracle(const Dataset& dataset, double errorProbability)
-        : dataset_(dataset), errorProbability_(errorProbability), rng_(std::random_device()()), comparisonCount_(0) {
+Oracle::Oracle(std::shared_ptr<Judge> judge)
+        : dataset_(0, judge->itemDimension()), judge_(judge), errorProbability_(judge->errorProbability()), seed_(0),
+          stream_(0), forkCount_(0), comparisonCount_(0) {
 }
 
 size_type Oracle::itemCount() const {
-    return dataset_.size();
+    return judge_ ? judge_->itemCount() : dataset_.size();
 }
 
 size_type Oracle::itemDimension() const {
@@ -200,70 +351,501 @@ double Oracle::errorProbability() const {
     return errorProbability_;
 }
 
+bool Oracle::remote() const {
+    return static_cast<bool>(judge_);
+}
+
 bool Oracle::less(size_type i, size_type j, size_type k) {
+    if (judge_) {
+        comparisonCount_++;
+        ItemPair pair{i, j};
+        unsigned char result;
+        judge_->lessBatch(&pair, &k, 1, &result);
+        return result != 0;
+    }
     bool correctResult = dataset_(i,k) < dataset_(j,k);
-    comparisonCount_++;
-    double sample = std::generate_canonical<double, std::numeric_limits<double>::digits>(rng_);
-    return (sample < errorProbability_) ? !correctResult : correctResult;
+    return erroneous(comparisonCount_++) ? !correctResult : correctResult;
+}
+
+void Oracle::lessBatch(const ItemPair* pairs, const size_type* dims, size_type count, unsigned char* results) {
+    if (judge_) {
+        judge_->lessBatch(pairs, dims, count, results);
+        comparisonCount_ += count;
+        return;
+    }
+    std::uint64_t first = comparisonCount_;
+    for (size_type q = 0; q < count; q++) {
+        results[q] = erroneous(first + q);
+    }
+    for (size_type q = 0; q < count; q++) {
+        bool correctResult = dataset_(pairs[q].i, dims[q]) < dataset_(pairs[q].j, dims[q]);
+        results[q] = (results[q] != 0) != correctResult;
+    }
+    comparisonCount_ += count;
+}
+
+bool Oracle::erroneous(std::uint64_t query) const {
+    return uniformCanonical(philox(query, stream_, seed_)) < errorProbability_;
 }
 
 size_type Oracle::comparisonCount() const {
     return comparisonCount_;
 }
 
-bool less(Oracle& oracle, size_type i, size_type j, size_type k, double tolerance) {
+Oracle Oracle::fork() {
+    Oracle forked(*this);
+    // Hash with a key that differs from the seed, so that forked streams are unrelated to query counters.
+    forked.stream_ = philox(forkCount_++, stream_, ~seed_);
+    forked.forkCount_ = 0;
+    forked.comparisonCount_ = 0;
+    return forked;
+}
+
+void Oracle::join(const Oracle& forked) {
+    comparisonCount_ += forked.comparisonCount_;
+}
+
+bool less(NoisyContext& context, Oracle& oracle, size_type i, size_type j, size_type k, double tolerance) {
+    context.stats.comparisonCount++;
+    switch (context.options.comparisonMode) {
+        case ComparisonMode::sequential: {
+            return lessSequential(oracle, i, j, k, tolerance);
+        }
+        case ComparisonMode::majority: {
+            return lessMajority(oracle, i, j, k, tolerance);
+        }
+    }
+    throw std::logic_error("unknown comparison mode");
+}
+
+bool lessMajority(Oracle& oracle, size_type i, size_type j, size_type k, double tolerance) {
     // If the oracle is good enough, use it's result directly.
     // Otherwise, take the majority of 3 comparisons, while allowing 2*tolerance error probability.
     if (oracle.errorProbability() <= tolerance) {
         return oracle.less(i, j, k);
+    } else if (oracle.errorProbability() <= 2*tolerance) {
+        // The first 2 votes are always needed, so they are queried at once.
+        ItemPair pairs[2] = {{i, j}, {i, j}};
+        size_type dims[2] = {k, k};
+        unsigned char results[2];
+        oracle.lessBatch(pairs, dims, 2, results);
+        return (results[0] != results[1]) ? oracle.less(i, j, k) : results[0] != 0;
     } else {
-        bool result1 = less(oracle, i, j, k, 2*tolerance);
-        bool result2 = less(oracle, i, j, k, 2*tolerance);
+        bool result1 = lessMajority(oracle, i, j, k, 2*tolerance);
+        bool result2 = lessMajority(oracle, i, j, k, 2*tolerance);
         // Save 1 call to the underlying oracle if the first 2 results are the same.
-        return (result1 ^ result2) ? less(oracle, i, j, k, 2*tolerance) : result1;
+        return (result1 ^ result2) ? lessMajority(oracle, i, j, k, 2*tolerance) : result1;
     }
 }
 
-bool lessLex(Oracle& oracle, size_type i, size_type j, double tolerance) {
+void lessMany(NoisyContext& context, Oracle& oracle, const ItemPair* pairs, const size_type* dims, size_type count,
+        double tolerance, unsigned char* results) {
+    context.stats.comparisonCount += count;
+    switch (context.options.comparisonMode) {
+        case ComparisonMode::sequential: {
+            lessSequentialMany(oracle, pairs, dims, count, tolerance, results);
+            return;
+        }
+        case ComparisonMode::majority: {
+            lessMajorityMany(oracle, pairs, dims, count, tolerance, results, 0);
+            return;
+        }
+    }
+    throw std::logic_error("unknown comparison mode");
+}
+
+/** Buffers of one level of recursion of lessMajorityMany(). */
+struct MajorityBuffers {
+    std::vector<ItemPair> pairs;
+    std::vector<size_type> dims;
+    std::vector<unsigned char> votes;
+    std::vector<size_type> ties;
+};
+
+void lessMajorityMany(Oracle& oracle, const ItemPair* pairs, const size_type* dims, size_type count,
+        double tolerance, unsigned char* results, size_type level) {
+    if (oracle.errorProbability() <= tolerance) {
+        oracle.lessBatch(pairs, dims, count, results);
+        return;
+    }
+    // Reused by all calls in the thread at the same level, so that calls do not allocate once they have grown;
+    // a deque keeps the buffers of the outer levels in place when a deeper level is added.
+    static thread_local std::deque<MajorityBuffers> levels;
+    if (levels.size() <= level) {
+        levels.resize(level + 1);
+    }
+    auto& votePairs = levels[level].pairs;
+    auto& voteDims = levels[level].dims;
+    auto& votes = levels[level].votes;
+    auto& ties = levels[level].ties;
+    // The first 2 results of every comparison are computed at once, then the third ones of those that disagree.
+    votePairs.assign(pairs, pairs + count);
+    votePairs.insert(votePairs.end(), pairs, pairs + count);
+    voteDims.assign(dims, dims + count);
+    voteDims.insert(voteDims.end(), dims, dims + count);
+    votes.resize(2*count);
+    auto subtolerance = (oracle.errorProbability() <= 2*tolerance) ? 1.0 : 2*tolerance;
+    lessMajorityMany(oracle, votePairs.data(), voteDims.data(), 2*count, subtolerance, votes.data(), level + 1);
+    ties.clear();
+    for (size_type q = 0; q < count; q++) {
+        results[q] = votes[q];
+        if (votes[q] != votes[count + q]) {
+            votePairs[ties.size()] = pairs[q];
+            voteDims[ties.size()] = dims[q];
+            ties.push_back(q);
+        }
+    }
+    if (!ties.empty()) {
+        lessMajorityMany(oracle, votePairs.data(), voteDims.data(), ties.size(), subtolerance, votes.data(), level + 1);
+        for (size_type t = 0; t < ties.size(); t++) {
+            results[ties[t]] = votes[t];
+        }
+    }
+}
+
+void lessSequentialMany(Oracle& oracle, const ItemPair* pairs, const size_type* dims, size_type count,
+        double tolerance, unsigned char* results) {
+    double p = oracle.errorProbability();
+    if (p <= tolerance) {
+        oracle.lessBatch(pairs, dims, count, results);
+        return;
+    }
+    auto threshold = static_cast<long>(std::ceil(std::log((1 - tolerance) / tolerance) / std::log((1 - p) / p)));
+    // Reused by all calls in the thread, so that calls do not allocate once they have grown.
+    static thread_local std::vector<long> walks;
+    static thread_local std::vector<ItemPair> votePairs;
+    static thread_local std::vector<size_type> voteDims;
+    static thread_local std::vector<size_type> voteOwners;
+    static thread_local std::vector<unsigned char> votes;
+    walks.assign(count, 0);
+    while (true) {
+        // Every walk that has not reached a threshold takes as many answers as lessSequential() would at once.
+        votePairs.clear();
+        voteDims.clear();
+        voteOwners.clear();
+        for (size_type q = 0; q < count; q++) {
+            for (auto v = std::abs(walks[q]); v < threshold; v++) {
+                votePairs.push_back(pairs[q]);
+                voteDims.push_back(dims[q]);
+                voteOwners.push_back(q);
+            }
+        }
+        if (votePairs.empty()) {
+            break;
+        }
+        votes.resize(votePairs.size());
+        oracle.lessBatch(votePairs.data(), voteDims.data(), votePairs.size(), votes.data());
+        for (size_type v = 0; v < votePairs.size(); v++) {
+            walks[voteOwners[v]] += votes[v] ? 1 : -1;
+        }
+    }
+    for (size_type q = 0; q < count; q++) {
+        results[q] = walks[q] > 0;
+    }
+}
+
+double queryCost(const NoisyContext& context, const Oracle& oracle, double tolerance) {
+    double p = oracle.errorProbability();
+    if (p <= tolerance) {
+        return 1.0;
+    }
+    switch (context.options.comparisonMode) {
+        case ComparisonMode::sequential: {
+            // The walk moves towards the correct threshold by 1 - 2p per query on average.
+            return std::ceil(std::log((1 - tolerance) / tolerance) / std::log((1 - p) / p)) / (1 - 2*p);
+        }
+        case ComparisonMode::majority: {
+            // Each level of lessMajority() doubles the tolerance, and takes a third vote if the first two disagree.
+            double cost = 1.0;
+            for (; p > tolerance; tolerance *= 2) {
+                auto error = std::min(p, 2*tolerance);
+                cost *= 2 + 2*error*(1 - error);
+            }
+            return cost;
+        }
+    }
+    throw std::logic_error("unknown comparison mode");
+}
+
+bool lessSequential(Oracle& oracle, size_type i, size_type j, size_type k, double tolerance) {
+    double p = oracle.errorProbability();
+    if (p <= tolerance) {
+        return oracle.less(i, j, k);
+    }
+    auto threshold = static_cast<long>(std::ceil(std::log((1 - tolerance) / tolerance) / std::log((1 - p) / p)));
+    // The walk cannot reach either threshold in less than threshold - |walk| steps,
+    // so that many answers are queried at once, without changing the answers or their number.
+    const long BATCH = 64;
+    ItemPair pairs[BATCH];
+    size_type dims[BATCH];
+    unsigned char results[BATCH];
+    std::fill(pairs, pairs + BATCH, ItemPair{i, j});
+    std::fill(dims, dims + BATCH, k);
+    long walk = 0;
+    while (walk < threshold && walk > -threshold) {
+        auto count = std::min(threshold - std::abs(walk), BATCH);
+        oracle.lessBatch(pairs, dims, static_cast<size_type>(count), results);
+        for (long q = 0; q < count; q++) {
+            walk += results[q] ? 1 : -1;
+        }
+    }
+    return walk > 0;
+}
+
+bool lessLex(NoisyContext& context, Oracle& oracle, size_type i, size_type j, double tolerance) {
+    PHASE_SCOPE(context.stats.lessLex, oracle);
+    switch (oracle.itemDimension()) {
+#define LESS_LEX_FIXED(D) \
+        case D: { \
+            return lessLexFixed<D>(context, oracle, i, j, tolerance); \
+        }
+        SKYLINE_FIXED_DIMS(LESS_LEX_FIXED)
+#undef LESS_LEX_FIXED
+        default: {
+            return lessLexFixed<0>(context, oracle, i, j, tolerance);
+        }
+    }
+}
+
+template<size_type D>
+bool lessLexFixed(NoisyContext& context, Oracle& oracle, size_type i, size_type j, double tolerance) {
+    const size_type ndims = fixedDims<D>(oracle.itemDimension());
     // TODO: Save calls to the underlying oracle by computing gt first and returning early?
     size_type lt = 0;
-    for (; lt < oracle.itemDimension(); lt++) {
-        if (less(oracle, i, j, lt, tolerance/2)) {
+    for (; lt < ndims; lt++) {
+        if (less(context, oracle, i, j, lt, tolerance/2)) {
             break;
         }
     }
     size_type gt = 0;
-    for (; gt < oracle.itemDimension(); gt++) {
+    for (; gt < ndims; gt++) {
         // i_gt > j_gt?
-        if (less(oracle, j, i, gt, tolerance/2)) {
+        if (less(context, oracle, j, i, gt, tolerance/2)) {
             break;
         }
     }
-    return (gt == oracle.itemDimension()) || (lt <= gt);
+    return (gt == ndims) || (lt <= gt);
+}
+
+bool dominatedBy(NoisyContext& context, Oracle& oracle, size_type i, size_type j, double tolerance) {
+    switch (oracle.itemDimension()) {
+#define DOMINATED_BY_FIXED(D) \
+        case D: { \
+            return dominatedByFixed<D>(context, oracle, i, j, tolerance); \
+        }
+        SKYLINE_FIXED_DIMS(DOMINATED_BY_FIXED)
+#undef DOMINATED_BY_FIXED
+        default: {
+            return dominatedByFixed<0>(context, oracle, i, j, tolerance);
+        }
+    }
 }
 
-bool dominatedBy(Oracle& oracle, size_type i, size_type j, double tolerance) {
-    for (size_type k = 0; k < oracle.itemDimension(); k++) {
+template<size_type D>
+bool dominatedByFixed(NoisyContext& context, Oracle& oracle, size_type i, size_type j, double tolerance) {
+    for (size_type k = 0; k < fixedDims<D>(oracle.itemDimension()); k++) {
         // If item i is greater than item j on some dimension, then i is not dominated by j.
-        if (less(oracle, j, i, k, tolerance)) {
+        if (less(context, oracle, j, i, k, tolerance)) {
             return false;
         }
     }
     return true;
 }
 
-bool dominatedByAny(Oracle& oracle, size_type i, const Skyline& c, double tolerance) {
+bool dominatedByAny(NoisyContext& context, Oracle& oracle, size_type i, const Skyline& c, double tolerance) {
     for (auto j : c) {
-        if (dominatedBy(oracle, i, j, tolerance)) {
+        if (dominatedBy(context, oracle, i, j, tolerance)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+DominanceState::DominanceState(size_type itemCount, size_type itemDimension, bool sorted)
+        : sorted_(sorted), orders_(sorted ? itemDimension : 0), ranks_(sorted ? itemDimension : 0),
+          indexed_(0), indexTolerance_(0.0), checked_(itemCount, 0), tolerance_(itemCount, 0.0),
+          dominated_(itemCount, false) {
+}
+
+const Skyline& DominanceState::skyline() const {
+    return skyline_;
+}
+
+void DominanceState::push(size_type item) {
+    skyline_.push_back(item);
+}
+
+double DominanceState::index(NoisyContext& context, Oracle& oracle, double tolerance) {
+    if (!sorted_) {
+        return tolerance;
+    }
+    if (indexTolerance_ > tolerance) {
+        // The orderings are not reliable enough for the following samples.
+        indexed_ = 0;
+    }
+    auto first = indexed_;
+    if (first == skyline_.size()) {
+        return tolerance;
+    }
+    // The next tournament checks every item that is not known to be dominated, mostly with half its tolerance
+    // (see max4LexNotDominated()); a linear scan costs at least one comparison per skyline item,
+    // a sorted check costs the searches. With the insertions, the tournament gets only half of the tolerance.
+    auto linearQuery = queryCost(context, oracle, tolerance/2);
+    auto sortedQuery = queryCost(context, oracle, tolerance/4);
+    auto search = searchCost(context, oracle, skyline_.size(), tolerance/4);
+    double saving = 0.0;
+    for (size_type i = 0; i < checked_.size(); i++) {
+        saving += static_cast<double>(expectedScan(i, tolerance/2)) * linearQuery
+                - std::min(static_cast<double>(expectedScan(i, tolerance/4)) * sortedQuery, search);
+    }
+    auto pending = skyline_.size() - first;
+    auto insertionTolerance = tolerance / 2 / static_cast<double>(pending * orders_.size());
+    auto insertion = searchCost(context, oracle, skyline_.size(), insertionTolerance);
+    if (saving <= static_cast<double>(pending) * insertion) {
+        return tolerance;
+    }
+
+    PHASE_SCOPE(context.stats.push, oracle);
+    for (size_type k = 0; k < orders_.size(); k++) {
+        orders_[k].resize(first);
+        ranks_[k].resize(first);
+    }
+    for (auto m = first; m < skyline_.size(); m++) {
+        for (size_type k = 0; k < orders_.size(); k++) {
+            auto position = lowerBound(context, oracle, orders_[k], skyline_[m], k, insertionTolerance);
+            orders_[k].insert(orders_[k].begin() + static_cast<std::ptrdiff_t>(position), skyline_[m]);
+            for (auto& rank : ranks_[k]) {
+                if (rank >= position) {
+                    rank++;
+                }
+            }
+            ranks_[k].push_back(position);
+        }
+    }
+    indexed_ = skyline_.size();
+    indexTolerance_ = tolerance;
+    return tolerance/2;
+}
+
+size_type DominanceState::expectedScan(size_type i, double tolerance) const {
+    if (tolerance_[i] <= tolerance) {
+        return dominated_[i] ? 0 : skyline_.size() - checked_[i];
+    }
+    return dominated_[i] ? checked_[i] : skyline_.size();
+}
+
+bool dominatedByAny(NoisyContext& context, Oracle& oracle, size_type i, DominanceState& c, double tolerance) {
+    PHASE_SCOPE(context.stats.dominatedByAny, oracle);
+    auto scan = c.expectedScan(i, tolerance);
+    if (c.tolerance_[i] > tolerance) {
+        // Previous verdicts are not reliable enough: start over.
+        c.checked_[i] = 0;
+        c.tolerance_[i] = 0.0;
+        c.dominated_[i] = false;
+    }
+    if (c.dominated_[i]) {
+        return true;
+    }
+    if (c.indexed_ > c.checked_[i]) {
+        auto unchecked = static_cast<double>(std::min(scan, c.indexed_ - c.checked_[i]));
+        if (unchecked * queryCost(context, oracle, tolerance) > searchCost(context, oracle, c.indexed_, tolerance)) {
+            c.tolerance_[i] = std::max(c.tolerance_[i], tolerance);
+            c.dominated_[i] = dominatedByAnySorted(context, oracle, i, c, tolerance);
+            c.checked_[i] = c.indexed_;
+        }
+    }
+    if (oracle.remote()) {
+        return dominatedByAnyBatched(context, oracle, i, c, tolerance);
+    }
+    for (; !c.dominated_[i] && c.checked_[i] < c.skyline_.size(); c.checked_[i]++) {
+        c.tolerance_[i] = std::max(c.tolerance_[i], tolerance);
+        if (dominatedBy(context, oracle, i, c.skyline_[c.checked_[i]], tolerance)) {
+            c.dominated_[i] = true;
+        }
+    }
+    return c.dominated_[i];
+}
+
+bool dominatedByAnyBatched(NoisyContext& context, Oracle& oracle, size_type i, DominanceState& c, double tolerance) {
+    const size_type BATCH = 64;
+    auto ndims = oracle.itemDimension();
+    auto chunk = std::max<size_type>(BATCH / ndims, 1);
+    // Reused by all checks in the thread, so that checks do not allocate once they have grown.
+    static thread_local std::vector<ItemPair> pairs;
+    static thread_local std::vector<size_type> dims;
+    static thread_local std::vector<unsigned char> results;
+    results.resize(chunk * ndims);
+    while (!c.dominated_[i] && c.checked_[i] < c.skyline_.size()) {
+        auto count = std::min(chunk, c.skyline_.size() - c.checked_[i]);
+        pairs.clear();
+        dims.clear();
+        for (size_type m = 0; m < count; m++) {
+            for (size_type k = 0; k < ndims; k++) {
+                pairs.push_back({c.skyline_[c.checked_[i] + m], i});
+                dims.push_back(k);
+            }
+        }
+        c.tolerance_[i] = std::max(c.tolerance_[i], tolerance);
+        lessMany(context, oracle, pairs.data(), dims.data(), pairs.size(), tolerance, results.data());
+        // Skyline item j dominates item i unless it is less than item i on some dimension, as in dominatedBy().
+        for (size_type m = 0; m < count && !c.dominated_[i]; m++) {
+            c.dominated_[i] = std::none_of(&results[m * ndims], &results[(m + 1) * ndims], [](unsigned char r) { return r != 0; });
+            c.checked_[i]++;
+        }
+    }
+    return c.dominated_[i];
+}
+
+size_type lowerBound(NoisyContext& context, Oracle& oracle, const Skyline& order, size_type i, size_type k, double tolerance) {
+    // Split the tolerance between all steps of the search.
+    auto steps = std::ceil(std::log2(static_cast<double>(order.size() + 1)));
+    size_type first = 0;
+    size_type count = order.size();
+    while (count > 0) {
+        size_type half = count / 2;
+        if (less(context, oracle, order[first + half], i, k, tolerance / steps)) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    return first;
+}
+
+double searchCost(const NoisyContext& context, const Oracle& oracle, size_type count, double tolerance) {
+    auto steps = std::ceil(std::log2(static_cast<double>(count + 1)));
+    return static_cast<double>(oracle.itemDimension()) * steps * queryCost(context, oracle, tolerance / steps);
+}
+
+bool dominatedByAnySorted(NoisyContext& context, Oracle& oracle, size_type i, const DominanceState& c, double tolerance) {
+    PHASE_SCOPE(context.stats.dominatedByAnySorted, oracle);
+    // Reused by all checks in the thread, so that checks do not allocate.
+    static thread_local std::vector<size_type> bounds;
+    bounds.resize(c.orders_.size());
+    for (size_type k = 0; k < c.orders_.size(); k++) {
+        bounds[k] = lowerBound(context, oracle, c.orders_[k], i, k, tolerance);
+        if (bounds[k] == c.indexed_) {
+            // All indexed items of c are less than item i on dimension k.
+            return false;
+        }
+    }
+    // Items before checked_ are already known not to dominate item i.
+    for (auto m = c.checked_[i]; m < c.indexed_; m++) {
+        bool candidate = true;
+        for (size_type k = 0; k < c.orders_.size() && candidate; k++) {
+            candidate = c.ranks_[k][m] >= bounds[k];
+        }
+        if (candidate && dominatedBy(context, oracle, i, c.skyline_[m], tolerance)) {
             return true;
         }
     }
     return false;
 }
 
-ternary lessLexNotDominated(Oracle& oracle, size_type i, size_type j, const Skyline& c, double tolerance) {
-    if (dominatedByAny(oracle, i, c, tolerance)) {
-        if (dominatedByAny(oracle, j, c, tolerance)) {
+ternary lessLexNotDominated(NoisyContext& context, Oracle& oracle, size_type i, size_type j, DominanceState& c, double tolerance) {
+    if (dominatedByAny(context, oracle, i, c, tolerance)) {
+        if (dominatedByAny(context, oracle, j, c, tolerance)) {
             // Both items are dominated, there is no ordering for them.
             return ternary::unknown;
         } else {
@@ -271,28 +853,29 @@ ternary lessLexNotDominated(Oracle& oracle, size_type i, size_type j, const Skyl
             return ternary::true_;
         }
     } else {
-        if (dominatedByAny(oracle, j, c, tolerance)) {
+        if (dominatedByAny(context, oracle, j, c, tolerance)) {
             // Item i is NOT dominated, item j is dominated: i > j
             return ternary::false_;
         } else {
             // Both items i and j are not dominated: the result is determined by lexicographic ordering.
-            return lessLex(oracle, i, j, tolerance) ? ternary::true_ : ternary::false_;
+            return lessLex(context, oracle, i, j, tolerance) ? ternary::true_ : ternary::false_;
         }
     }
 }
 
-size_type max2LexNotDominated(Oracle& oracle, size_type i, size_type j, const Skyline& c, double tolerance) {
+size_type max2LexNotDominated(NoisyContext& context, Oracle& oracle, size_type i, size_type j, DominanceState& c, double tolerance) {
+    // An item without an opponent still has to be checked, or a dominated item could win the tournament.
     if (i == NULL_SKYLINE) {
-        if (j == NULL_SKYLINE) {
+        if (j == NULL_SKYLINE || dominatedByAny(context, oracle, j, c, tolerance)) {
             return NULL_SKYLINE;
         } else {
             return j;
         }
     } else {
         if (j == NULL_SKYLINE) {
-            return i;
+            return dominatedByAny(context, oracle, i, c, tolerance) ? NULL_SKYLINE : i;
         } else {
-            switch (lessLexNotDominated(oracle, i, j, c, tolerance)) {
+            switch (lessLexNotDominated(context, oracle, i, j, c, tolerance)) {
                 case ternary::true_: {
                     return j;
                 }
@@ -305,25 +888,26 @@ size_type max2LexNotDominated(Oracle& oracle, size_type i, size_type j, const Sk
             }
         }
     }
+    throw std::logic_error("unknown ternary value");
 }
 
-size_type max4LexNotDominated(Oracle& oracle, const Skyline& s,
-        Skyline::size_type offset, Skyline::size_type n, const Skyline& c, double tolerance) {
+size_type max4LexNotDominated(NoisyContext& context, Oracle& oracle, const Skyline& s,
+        Skyline::size_type offset, Skyline::size_type n, DominanceState& c, double tolerance) {
     switch (n) {
         case 1: {
-            return s[offset];
+            return max2LexNotDominated(context, oracle, s[offset], NULL_SKYLINE, c, tolerance);
         }
         case 2: {
-            return max2LexNotDominated(oracle, s[offset], s[offset+1], c, tolerance);
+            return max2LexNotDominated(context, oracle, s[offset], s[offset+1], c, tolerance);
         }
         case 3: {
-            size_type max01 = max2LexNotDominated(oracle, s[offset], s[offset+1], c, tolerance/2);
-            return max2LexNotDominated(oracle, max01, s[offset+2], c, tolerance/2);
+            size_type max01 = max2LexNotDominated(context, oracle, s[offset], s[offset+1], c, tolerance/2);
+            return max2LexNotDominated(context, oracle, max01, s[offset+2], c, tolerance/2);
         }
         case 4: {
-            size_type max01 = max2LexNotDominated(oracle, s[offset], s[offset+1], c, tolerance/2);
-            size_type max23 = max2LexNotDominated(oracle, s[offset+2], s[offset+3], c, tolerance/2);
-            return max2LexNotDominated(oracle, max01, max23, c, tolerance/2);
+            size_type max01 = max2LexNotDominated(context, oracle, s[offset], s[offset+1], c, tolerance/2);
+            size_type max23 = max2LexNotDominated(context, oracle, s[offset+2], s[offset+3], c, tolerance/2);
+            return max2LexNotDominated(context, oracle, max01, max23, c, tolerance/2);
         }
         default: {
             throw std::invalid_argument("n is not in range [1..4]");
@@ -331,40 +915,124 @@ size_type max4LexNotDominated(Oracle& oracle, const Skyline& s,
     }
 }
 
-size_type maxLexNotDominated(Oracle& oracle, const Skyline& s, const Skyline& c, double tolerance) {
-    if (s.size() <= 4) {
-        return max4LexNotDominated(oracle, s, 0, s.size(), c, tolerance);
-    }
-    Skyline smax((s.size() - 1) / 4 + 1);
-    size_type i = 0;
-    for (; i < smax.size() - 1; i++) {
-        smax[i] = max4LexNotDominated(oracle, s, 4*i, 4, c, tolerance);
+Tournament::Tournament(size_type itemCount) {
+    auto groups = (itemCount + 3) / 4;
+    winners[0].resize(groups);
+    winners[1].resize(groups);
+    oracles.reserve(groups);
+}
+
+size_type maxLexNotDominated(NoisyContext& context, Oracle& oracle, const Skyline& s, DominanceState& c, double tolerance,
+        Tournament& t) {
+    const Skyline* items = &s;
+    size_type count = s.size();
+    for (size_type level = 0; count > 4; level++) {
+        Skyline& smax = t.winners[level % 2];
+        size_type groups = (count - 1) / 4 + 1;
+        // Groups are independent and touch distinct items of c, so they are evaluated in parallel,
+        // each with its own oracle; forks are made in order, so the result does not depend on the thread count.
+        t.oracles.clear();
+        for (size_type i = 0; i < groups; i++) {
+            t.oracles.push_back(oracle.fork());
+        }
+        auto group = [&](size_type i) {
+            // The last group may be smaller.
+            smax[i] = max4LexNotDominated(context, t.oracles[i], *items, 4*i, std::min<size_type>(4, count - 4*i),
+                    c, tolerance);
+        };
+        // A reference wrapper is stored in std::function without allocating.
+        context.options.threadPool->parallelFor(0, groups, std::ref(group));
+        for (auto& forked : t.oracles) {
+            oracle.join(forked);
+        }
+        items = &smax;
+        count = groups;
     }
-    // The last group may be smaller.
-    smax[i] = max4LexNotDominated(oracle, s, 4*i, s.size() - 4*i, c, tolerance);
-    return maxLexNotDominated(oracle, smax, c, tolerance);
+    return max4LexNotDominated(context, oracle, *items, 0, count, c, tolerance);
 }
 
-void skySample(Oracle& oracle, const Skyline& s, size_type n, double tolerance, Skyline& skyline) {
-    skyline.clear();
-    for (size_type i = 0; i < n; i++) {
-        size_type z = maxLexNotDominated(oracle, s, skyline, tolerance/n);
+void skySample(NoisyContext& context, Oracle& oracle, const Skyline& s, size_type n, double tolerance, DominanceState& c) {
+    Tournament t(s.size());
+    auto first = c.skyline().size();
+    for (size_type i = first; i < n; i++) {
+        size_type z;
+        auto tournamentTolerance = c.index(context, oracle, tolerance/n);
+        {
+            // Measured here, around the whole tournament.
+            PHASE_SCOPE(context.stats.maxLexNotDominated, oracle);
+            z = maxLexNotDominated(context, oracle, s, c, tournamentTolerance, t);
+        }
         if (z == NULL_SKYLINE) {
-            return;
+            break;
         }
-        skyline.push_back(z);
+        c.push(z);
     }
 }
 
-void noisy(Oracle& oracle, double tolerance, Skyline& skyline) {
+void skyVerify(NoisyContext& context, Oracle& oracle, const Skyline& s, double tolerance,
+        std::unique_ptr<DominanceState>& c) {
+    const Skyline& prefix = c->skyline();
+    // Items are checked in parallel, each with its own oracle, as the groups of a tournament.
+    std::vector<Oracle> oracles;
+    oracles.reserve(prefix.size());
+    for (size_type m = 0; m < prefix.size(); m++) {
+        oracles.push_back(oracle.fork());
+    }
+    std::vector<unsigned char> dominated(prefix.size());
+    auto check = [&](size_type m) {
+        auto i = prefix[m];
+        dominated[m] = std::any_of(s.begin(), s.end(), [&](size_type j) {
+            return j != i && dominatedBy(context, oracles[m], i, j, tolerance);
+        });
+    };
+    context.options.threadPool->parallelFor(0, prefix.size(), std::ref(check));
+    for (auto& forked : oracles) {
+        oracle.join(forked);
+    }
+    Skyline verified;
+    for (size_type m = 0; m < prefix.size(); m++) {
+        if (!dominated[m]) {
+            verified.push_back(prefix[m]);
+        }
+    }
+    if (verified.size() == prefix.size()) {
+        return;
+    }
+    // The verdicts of other items may rest on the dropped items.
+    c.reset(new DominanceState(oracle.itemCount(), oracle.itemDimension(), context.options.sortedIndex));
+    for (auto i : verified) {
+        c->push(i);
+    }
+}
+
+void noisy(Oracle& oracle, double tolerance, const NoisyOptions& options, NoisyStats& stats, Skyline& skyline) {
+    // A pool without workers evaluates all groups in the calling thread.
+    ThreadPool serialPool(1);
+    NoisyOptions poolOptions = options;
+    if (poolOptions.threadPool == nullptr) {
+        poolOptions.threadPool = &serialPool;
+    }
+    NoisyContext context{poolOptions, stats};
     Skyline s(oracle.itemCount());
     std::iota(s.begin(), s.end(), 0);
+    std::unique_ptr<DominanceState> c;
     // int i = 1;
     int pow2i = 2; // 2^i
     size_type ni = 4; // 2^(2^i)
     while (true) {
-        skyline.clear();
-        skySample(oracle, s, ni, tolerance/pow2i, skyline);
+        auto queries = oracle.comparisonCount();
+        auto beforeTime = std::chrono::steady_clock::now();
+        if (!c || !options.reusePrefix) {
+            c.reset(new DominanceState(oracle.itemCount(), oracle.itemDimension(), options.sortedIndex));
+        } else {
+            // Items found by the previous round get the same share of the tolerance as the new samples.
+            skyVerify(context, oracle, s, tolerance/pow2i/ni, c);
+        }
+        skySample(context, oracle, s, ni, tolerance/pow2i, *c);
+        skyline = c->skyline();
+        auto elapsed = std::chrono::steady_clock::now() - beforeTime;
+        stats.rounds.push_back({ni, tolerance/pow2i, skyline.size(), oracle.comparisonCount() - queries,
+                static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count())});
         if (skyline.size() < ni) {
             return;
         }
@@ -373,3 +1041,9 @@ void noisy(Oracle& oracle, double tolerance, Skyline& skyline) {
         ni *= ni;
     }
 }
+
+bool noisyDominatedBy(Oracle& oracle, size_type i, size_type j, double tolerance,
+        const NoisyOptions& options, NoisyStats& stats) {
+    NoisyContext context{options, stats};
+    return dominatedBy(context, oracle, i, j, tolerance / static_cast<double>(oracle.itemDimension()));
+}
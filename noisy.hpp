@@ -0,0 +1,213 @@
+#ifndef NOISY_HPP_
+#define NOISY_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "common.hpp"
+#include "judge.hpp"
+#include "stats.hpp"
+#include "threadpool.hpp"
+
+/** How less() amplifies the confidence of oracle answers. */
+enum class ComparisonMode {
+    /** Recursive majority of 3 votes; the number of oracle calls depends only on the tolerance. */
+    majority,
+    /** Sequential probability ratio test; stops as soon as the answers are conclusive. */
+    sequential,
+};
+
+/**
+ * This class emulates queries to independent noisy oracles.
+ * It holds the real data and answers questions
+ * "Is i-th item is less than j-th item on dimension k?"
+ * with some predefined error probability.
+ * Also, it keeps track of number of such queries.
+ *
+ * Errors are drawn from the Philox generator keyed by the seed,
+ * with the sequence number of the query as the counter.
+ * Therefore, the answers are reproducible for a given seed,
+ * and do not depend on how the queries are split into batches.
+ * Oracles that are queried concurrently are obtained with fork(),
+ * and draw their errors from separate streams.
+ *
+ * Alternatively, the queries are answered by an external judge, which draws its own errors;
+ * then the oracle only counts the queries, and waits for their answers.
+ *
+ * Derived oracles should either this class
+ * or other derived oracles as a basis.
+ *
+ * After construction, there is no way to retreive
+ * the dataset for which the skyline should be computed.
+ * This ensures that derived oracles won't use
+ * the numerical values in the dataset directly.
+ */
+class Oracle {
+public:
+    /**
+     * Construct the oracle.
+     *
+     * @param dataset The dataset to use; must not be empty,
+     *     all items in the dataset must have the same size.
+     * @param errorProbability Ratio of correctness for queries to this oracle;
+     *     must be in the range [0.0; 0.5).
+     * @param seed Seed of the errors.
+     */
+    Oracle(const Dataset& dataset, double errorProbability, std::uint64_t seed);
+
+    /**
+     * Construct the oracle that passes the queries to the judge;
+     * the judge is shared by all forks of the oracle.
+     */
+    explicit Oracle(std::shared_ptr<Judge> judge);
+
+    /**
+     * Total number of items in the dataset.
+     */
+    size_type itemCount() const;
+
+    /**
+     * Dimension of every item in the underlying dataset.
+     */
+    size_type itemDimension() const;
+
+    /**
+     * Probability of returning the wrong result in compare().
+     */
+    double errorProbability() const;
+
+    /**
+     * Are the queries answered by a judge, so that answers come with latency?
+     */
+    bool remote() const;
+
+    /**
+     * Is item i is less than item j on a dimension k?
+     * The result is erroneous with probability errorProbability()
+     * (i.e. correct with probability 1 - errorProbability()).
+     */
+    bool less(size_type i, size_type j, size_type k);
+
+    /**
+     * Is item pairs[q].i less than item pairs[q].j on a dimension dims[q], for each q in [0; count)?
+     * Same as count calls to less() in order, but the errors for all queries are drawn in one vectorizable loop,
+     * or all queries are in flight to the judge at once.
+     */
+    void lessBatch(const ItemPair* pairs, const size_type* dims, size_type count, unsigned char* results);
+
+    /**
+     * The total number of comparisons made (that is, number of calls to compare()).
+     */
+    size_type comparisonCount() const;
+
+    /**
+     * Oracle for the same dataset that draws its errors from a separate stream.
+     * The stream is derived from the stream of this oracle and the number of previous forks,
+     * so forks made in the same order get the same streams in every run with the same seed.
+     * The forked oracle starts with zero comparisons.
+     */
+    Oracle fork();
+
+    /**
+     * Add the comparisons made by the forked oracle to the total number of comparisons of this oracle.
+     */
+    void join(const Oracle& forked);
+
+private:
+    /** Does the query with the specified sequence number get the wrong answer? */
+    bool erroneous(std::uint64_t query) const;
+
+    const Dataset dataset_;
+    const std::shared_ptr<Judge> judge_;
+    const double errorProbability_;
+    const std::uint64_t seed_;
+    std::uint64_t stream_;
+    std::uint64_t forkCount_;
+    size_type comparisonCount_;
+};
+
+/** Options of noisy(). */
+struct NoisyOptions {
+    /** Default options: majority votes, serial evaluation, linear dominance checks, rounds sampled from scratch. */
+    NoisyOptions();
+
+    /** How less() amplifies the confidence of oracle answers. */
+    ComparisonMode comparisonMode;
+    /** Pool that evaluates independent groups of the tournament, or nullptr to evaluate them in the calling thread. */
+    ThreadPool* threadPool;
+    /**
+     * Whether the skyline found so far may be kept sorted along each dimension to speed up dominance checks;
+     * it is sorted only when the binary searches are expected to save oracle calls.
+     * That happens mostly together with reusePrefix, when checks made in the previous round are repeated;
+     * with fresh rounds, a check mostly covers the one skyline item added since the previous check of the item.
+     * A sample that extends the orderings reserves half of its tolerance for the insertions,
+     * split between the binary searches of each inserted item along each dimension.
+     */
+    bool sortedIndex;
+    /**
+     * Whether each doubling round starts from the skyline items found by the previous round,
+     * and their dominance checks, instead of sampling them again with its tighter tolerance.
+     * The tolerance of a round is split between all its samples: every carried item is first checked again
+     * for dominance by every item with the share of one sample, and dropped if it is dominated,
+     * and dominance verdicts made with a larger tolerance are checked again when they are needed.
+     */
+    bool reusePrefix;
+};
+
+/** Statistics of one doubling round of noisy(). */
+struct RoundStats {
+    /** Maximal number of skyline items to sample. */
+    size_type samples;
+    /** Tolerance of the round. */
+    double tolerance;
+    /** Number of sampled skyline items. */
+    size_type skylineSize;
+    /** Number of queries to the oracle. */
+    std::uint64_t queries;
+    /** Running time. */
+    std::uint64_t nanoseconds;
+};
+
+/**
+ * Statistics of one computation of noisy().
+ * Rounds are always collected; phases time every call, so they are collected only if compiled with SKYLINE_STATS.
+ */
+struct NoisyStats {
+    NoisyStats();
+
+    /** Number of comparisons (that is, calls to less()); updated concurrently. */
+    std::atomic<size_type> comparisonCount;
+    PhaseStats lessLex;
+    PhaseStats dominatedByAny;
+    PhaseStats dominatedByAnySorted;
+    /** Insertions into the sorted index of the skyline. */
+    PhaseStats push;
+    /** Top-level calls of the tournament from skySample(). */
+    PhaseStats maxLexNotDominated;
+    std::vector<RoundStats> rounds;
+};
+
+/**
+ * Compute skyline from the entire dataset; statistics are added to stats.
+ * Reentrant: concurrent computations must use separate oracles and statistics, but may share the options.
+ */
+void noisy(Oracle& oracle, double tolerance, const NoisyOptions& options, NoisyStats& stats, Skyline& result);
+
+/**
+ * Is item i dominated by item j?
+ * The result is wrong with probability at most tolerance, which is split between the dimensions;
+ * statistics are added to stats.
+ */
+bool noisyDominatedBy(Oracle& oracle, size_type i, size_type j, double tolerance,
+        const NoisyOptions& options, NoisyStats& stats);
+
+/**
+ * Write statistics as JSON object:
+ * the number of comparisons, and the number of calls, oracle calls and time of every phase and every doubling round.
+ */
+void noisyStatsWrite(std::ostream& out, const NoisyStats& stats);
+
+#endif // NOISY_HPP_
@@ -0,0 +1,120 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "skyline.hpp"
+
+/** Main entry point. */
+int main(int argc, char** argv) {
+    const char* statsOutput = nullptr;
+    const char* judgeLatency = nullptr;
+    const char* judgeConcurrency = nullptr;
+    while (true) {
+        if (argc >= 3 && std::strcmp(argv[argc - 2], "--stats") == 0) {
+            statsOutput = argv[argc - 1];
+            argc -= 2;
+        } else if (argc >= 4 && std::strcmp(argv[argc - 3], "--judge") == 0) {
+            judgeLatency = argv[argc - 2];
+            judgeConcurrency = argv[argc - 1];
+            argc -= 3;
+        } else {
+            break;
+        }
+    }
+    if (argc < 7 || argc > 12) {
+        std::cerr << "Usage: " << argv[0]
+                << " input output size dimensions tolerance error_probability"
+                << " [seed [majority|sequential [threads [linear|sorted [fresh|reuse]]]]]"
+                << " [--judge latency_us concurrency] [--stats stats.json]" << std::endl;
+        std::cerr << "With --judge, queries are answered by skyline_oracle_service from the same directory,"
+                << " with the specified latency and number of queries served at once;"
+                << " use many threads to keep many queries in flight." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto input = argv[1];
+    auto output = argv[2];
+    auto size = datasetSizeParse(argv[3]);
+    auto dimensions = datasetSizeParse(argv[4]);
+    SkylineOptions options;
+    options.algorithm = Algorithm::noisy;
+    options.tolerance = std::stod(argv[5]);
+    options.errorProbability = std::stod(argv[6]);
+    options.seed = (argc >= 8) ? std::stoull(argv[7]) : std::random_device()();
+    if (argc >= 9) {
+        if (std::strcmp(argv[8], "sequential") == 0) {
+            options.comparisonMode = ComparisonMode::sequential;
+        } else if (std::strcmp(argv[8], "majority") != 0) {
+            std::cerr << "Unknown comparison mode: " << argv[8] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    auto threads = (argc >= 10) ? datasetSizeParse(argv[9]) : 1;
+    if (argc >= 11) {
+        if (std::strcmp(argv[10], "sorted") == 0) {
+            options.sortedIndex = true;
+        } else if (std::strcmp(argv[10], "linear") != 0) {
+            std::cerr << "Unknown dominance index: " << argv[10] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc >= 12) {
+        if (std::strcmp(argv[11], "reuse") == 0) {
+            options.reusePrefix = true;
+        } else if (std::strcmp(argv[11], "fresh") != 0) {
+            std::cerr << "Unknown round mode: " << argv[11] << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    try {
+        auto dataset = datasetMap(input, size, dimensions, MapHint::random);
+
+        ThreadPool pool(threads);
+        options.threadPool = &pool;
+        if (judgeLatency != nullptr) {
+            std::string service = argv[0];
+            service = service.substr(0, service.find_last_of('/') + 1) + "skyline_oracle_service";
+            options.judge = std::make_shared<ProcessJudge>(std::vector<std::string>{service, input, argv[3], argv[4],
+                    argv[6], judgeLatency, judgeConcurrency, std::to_string(options.seed)},
+                    size, dimensions, options.errorProbability);
+        }
+        Skyline skyline;
+        SkylineStats stats;
+        auto beforeTime = std::chrono::steady_clock::now();
+        skylineCompute(dataset, options, skyline, stats);
+        auto afterTime = std::chrono::steady_clock::now();
+
+        skylineWrite(skyline, output);
+
+        auto runningTime = std::chrono::duration_cast<std::chrono::milliseconds>(afterTime - beforeTime).count();
+        std::cout << runningTime << " " << stats.oracleCalls << std::endl;
+
+        if (statsOutput != nullptr) {
+            auto callsPerComparison = (stats.comparisonCount > 0)
+                    ? static_cast<double>(stats.oracleCalls) / static_cast<double>(stats.comparisonCount) : 0.0;
+            std::ofstream json(statsOutput);
+            json << "{\"running_time\": " << runningTime << ", \"oracle_calls\": " << stats.oracleCalls
+                    << ", \"calls_per_comparison\": " << callsPerComparison
+                    << ", \"skyline_size\": " << skyline.size() << ", \"noisy\": ";
+            noisyStatsWrite(json, stats.noisy);
+            json << "}" << std::endl;
+            if (!json) {
+                throw std::runtime_error(std::string("Cannot write file ") + statsOutput);
+            }
+        }
+
+        return EXIT_SUCCESS;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
+
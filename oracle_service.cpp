@@ -0,0 +1,106 @@
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common.hpp"
+
+/*
+ * Stand-in for an external judge, for testing ProcessJudge:
+ * answers queries "id i j k" from the standard input with "id 0|1" on the standard output,
+ * after the specified latency, with the specified number of queries served at once.
+ * Answers are correct except with the error probability, drawn from the Philox generator keyed by the seed,
+ * with the query id as the counter.
+ */
+
+/** Query waiting for a server. */
+struct Query {
+    std::uint64_t id;
+    size_type i;
+    size_type j;
+    size_type k;
+};
+
+/** Main entry point. */
+int main(int argc, char** argv) {
+    if (argc != 7 && argc != 8) {
+        std::cerr << "Usage: " << argv[0] << " input size dimensions error_probability latency_us concurrency [seed]"
+                << std::endl;
+        std::cerr << "Queries \"id i j k\" are read from the standard input,"
+                << " and answered by \"id 0|1\" on the standard output." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        auto dataset = datasetMap(argv[1], datasetSizeParse(argv[2]), datasetSizeParse(argv[3]), MapHint::populate);
+        auto errorProbability = std::stod(argv[4]);
+        auto latency = std::chrono::microseconds(std::stoll(argv[5]));
+        auto concurrency = datasetSizeParse(argv[6]);
+        std::uint64_t seed = (argc == 8) ? std::stoull(argv[7]) : 0;
+        if (concurrency == 0) {
+            throw std::runtime_error("Concurrency must be positive");
+        }
+
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::deque<Query> queue;
+        bool closed = false;
+        std::mutex outputMutex;
+        std::vector<std::thread> servers;
+        for (size_type s = 0; s < concurrency; s++) {
+            servers.emplace_back([&]() {
+                while (true) {
+                    Query query;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        ready.wait(lock, [&]() { return closed || !queue.empty(); });
+                        if (queue.empty()) {
+                            return;
+                        }
+                        query = queue.front();
+                        queue.pop_front();
+                    }
+                    std::this_thread::sleep_for(latency);
+                    bool answer = dataset(query.i, query.k) < dataset(query.j, query.k);
+                    if (uniformCanonical(philox(query.id, 0, seed)) < errorProbability) {
+                        answer = !answer;
+                    }
+                    std::lock_guard<std::mutex> lock(outputMutex);
+                    std::printf("%llu %d\n", static_cast<unsigned long long>(query.id), answer ? 1 : 0);
+                    std::fflush(stdout);
+                }
+            });
+        }
+
+        unsigned long long id, i, j, k;
+        while (std::scanf("%llu %llu %llu %llu", &id, &i, &j, &k) == 4) {
+            if (i >= dataset.size() || j >= dataset.size() || k >= dataset.ndims()) {
+                // The caller would wait for the answer forever, so stop: it will get no more answers.
+                std::cerr << "Query out of range: " << id << std::endl;
+                break;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back({id, i, j, k});
+            ready.notify_one();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        ready.notify_all();
+        for (auto& server : servers) {
+            server.join();
+        }
+        return EXIT_SUCCESS;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,92 @@
+#include "process.hpp"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+ChildProcess::ChildProcess(const std::vector<std::string>& command)
+        : pid_(-1), input_(-1), output_(-1) {
+    if (command.empty()) {
+        throw std::runtime_error("Empty command");
+    }
+    // Pipes are closed on exec, so that other children do not inherit them and keep them open;
+    // dup2() clears the flag on the standard input and output of this child.
+    int toChild[2], fromChild[2];
+    if (pipe2(toChild, O_CLOEXEC) != 0) {
+        throw std::runtime_error(std::string("Cannot create pipe: ") + std::strerror(errno));
+    }
+    if (pipe2(fromChild, O_CLOEXEC) != 0) {
+        int error = errno;
+        close(toChild[0]);
+        close(toChild[1]);
+        throw std::runtime_error(std::string("Cannot create pipe: ") + std::strerror(error));
+    }
+    // Arguments are prepared before forking, so that the child only calls async-signal-safe functions.
+    std::vector<char*> argv;
+    for (const auto& arg : command) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    pid_ = fork();
+    if (pid_ < 0) {
+        int error = errno;
+        close(toChild[0]);
+        close(toChild[1]);
+        close(fromChild[0]);
+        close(fromChild[1]);
+        throw std::runtime_error("Cannot start " + command[0] + ": " + std::strerror(error));
+    }
+    if (pid_ == 0) {
+        dup2(toChild[0], STDIN_FILENO);
+        dup2(fromChild[1], STDOUT_FILENO);
+        close(toChild[0]);
+        close(toChild[1]);
+        close(fromChild[0]);
+        close(fromChild[1]);
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    close(toChild[0]);
+    close(fromChild[1]);
+    input_ = toChild[1];
+    output_ = fromChild[0];
+    std::signal(SIGPIPE, SIG_IGN);
+}
+
+ChildProcess::~ChildProcess() {
+    closeInput();
+    close(output_);
+    wait();
+}
+
+int ChildProcess::input() const {
+    return input_;
+}
+
+int ChildProcess::output() const {
+    return output_;
+}
+
+void ChildProcess::closeInput() {
+    if (input_ >= 0) {
+        close(input_);
+        input_ = -1;
+    }
+}
+
+bool ChildProcess::wait() {
+    if (pid_ < 0) {
+        return false;
+    }
+    int status = 0;
+    while (waitpid(pid_, &status, 0) < 0 && errno == EINTR) {
+    }
+    pid_ = -1;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
@@ -0,0 +1,48 @@
+#ifndef PROCESS_HPP_
+#define PROCESS_HPP_
+
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+/** Child process with pipes to its standard input and from its standard output. */
+class ChildProcess {
+public:
+    /**
+     * Start the command, whose first element is the path of the executable.
+     * SIGPIPE is ignored from then on, so that writes to a child that exited fail instead of killing this process.
+     *
+     * @throws std::runtime_error if the process cannot be started.
+     */
+    explicit ChildProcess(const std::vector<std::string>& command);
+
+    /** Close the pipes, and wait for the process to exit unless wait() was called. */
+    ~ChildProcess();
+
+    ChildProcess(const ChildProcess&) = delete;
+    ChildProcess& operator=(const ChildProcess&) = delete;
+
+    /** Descriptor of the pipe to the standard input of the process, or -1 once closed. */
+    int input() const;
+
+    /** Descriptor of the pipe from the standard output of the process. */
+    int output() const;
+
+    /** Close the standard input of the process, so that it reads the end of file. */
+    void closeInput();
+
+    /**
+     * Wait for the process to exit.
+     *
+     * @return true if the process exited with status 0; false if it failed, or if it was already waited for.
+     */
+    bool wait();
+
+private:
+    pid_t pid_;
+    int input_;
+    int output_;
+};
+
+#endif // PROCESS_HPP_
@@ -0,0 +1,92 @@
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "subspace.hpp"
+
+/** Default capacity of the cache, in skyline items. */
+static const size_type CACHE_CAPACITY = 64 << 20;
+
+/**
+ * Keep the dataset file with values of type T resident, and answer subspace skyline queries,
+ * one per line of the standard input.
+ * Every answer is one line of the standard output: the comma-separated skyline indices,
+ * or "error: " followed by the reason if the query is invalid.
+ * The line "stats" is answered with the numbers of cached, shared and computed queries and of comparisons.
+ */
+template<typename T>
+static void serve(const char* input, size_type size, size_type dimensions, size_type capacity);
+
+/** Main entry point. */
+int main(int argc, char** argv) {
+    const char* type = "double";
+    if (argc >= 3 && std::strcmp(argv[argc - 2], "--type") == 0) {
+        type = argv[argc - 1];
+        argc -= 2;
+    }
+    if (argc != 4 && argc != 5) {
+        std::cerr << "Usage: " << argv[0] << " input size dimensions [cache_capacity]"
+                << " [--type double|float|int32|uint16]" << std::endl;
+        std::cerr << "Queries are read from the standard input, one subspace per line,"
+                << " as dimension indices separated by '+' (e.g. 0+2)." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto input = argv[1];
+    auto size = datasetSizeParse(argv[2]);
+    auto dimensions = datasetSizeParse(argv[3]);
+    auto capacity = (argc == 5) ? datasetSizeParse(argv[4]) : CACHE_CAPACITY;
+
+    try {
+        switch (valueTypeParse(type)) {
+            case ValueType::float64: {
+                serve<double>(input, size, dimensions, capacity);
+                break;
+            }
+            case ValueType::float32: {
+                serve<float>(input, size, dimensions, capacity);
+                break;
+            }
+            case ValueType::int32: {
+                serve<std::int32_t>(input, size, dimensions, capacity);
+                break;
+            }
+            case ValueType::uint16: {
+                serve<std::uint16_t>(input, size, dimensions, capacity);
+                break;
+            }
+        }
+        return EXIT_SUCCESS;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
+
+template<typename T>
+static void serve(const char* input, size_type size, size_type dimensions, size_type capacity) {
+    auto dataset = datasetMap<T>(input, size, dimensions, MapHint::populate);
+    SubspaceSkylines<T> skylines(dataset, capacity);
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (line == "stats") {
+            std::cout << skylines.hitCount() << " " << skylines.sharedCount() << " " << skylines.missCount()
+                    << " " << skylines.comparisonCount() << std::endl;
+            continue;
+        }
+        try {
+            const auto& skyline = skylines.query(subspaceParse(line, dataset.ndims()));
+            for (size_type i = 0; i < skyline.size(); i++) {
+                if (i > 0) {
+                    std::cout << ",";
+                }
+                std::cout << skyline[i];
+            }
+            std::cout << std::endl;
+        } catch (const std::invalid_argument& e) {
+            std::cout << "error: " << e.what() << std::endl;
+        }
+    }
+}
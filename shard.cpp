@@ -0,0 +1,167 @@
+#include "shard.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "process.hpp"
+
+/** Owning handle of a stdio file. */
+typedef std::unique_ptr<std::FILE, int(*)(std::FILE*)> FileHandle;
+
+/** Read exactly count bytes from the file. */
+static void shardReadBytes(std::FILE* f, void* bytes, size_type count, const std::string& name) {
+    if (std::fread(bytes, 1, count, f) != count) {
+        throw std::runtime_error("cannot read " + name);
+    }
+}
+
+/** Write exactly count bytes to the file. */
+static void shardWriteBytes(std::FILE* f, const void* bytes, size_type count) {
+    if (std::fwrite(bytes, 1, count, f) != count) {
+        throw std::runtime_error(std::string("cannot write shard result: ") + std::strerror(errno));
+    }
+}
+
+std::vector<Shard> shardSplit(size_type size, size_type count) {
+    std::vector<Shard> shards;
+    count = std::min(count, size);
+    for (size_type s = 0; s < count; s++) {
+        auto first = size * s / count;
+        shards.push_back({first, size * (s + 1) / count - first});
+    }
+    return shards;
+}
+
+SkylineOptions shardOptions(const SkylineOptions& options, size_type shards, size_type shard) {
+    SkylineOptions result = options;
+    result.tolerance = options.tolerance / static_cast<double>(shards + 1);
+    result.seed = philox(shard, options.seed, ~std::uint64_t{0});
+    result.threadPool = nullptr;
+    return result;
+}
+
+template<typename T>
+BasicDataset<T> shardRead(const char* filename, size_type size, size_type ndims, const Shard& shard) {
+    FileHandle f(datasetOpen(filename, size, ndims, sizeof(T)), &std::fclose);
+    BasicDataset<T> dataset(shard.count, ndims);
+    if (fseeko(f.get(), static_cast<off_t>(shard.first * ndims * sizeof(T)), SEEK_SET) != 0) {
+        throw std::runtime_error(std::string("cannot seek in ") + filename + ": " + std::strerror(errno));
+    }
+    shardReadBytes(f.get(), dataset.data(), shard.count * ndims * sizeof(T), filename);
+    return dataset;
+}
+
+template<typename T>
+void shardWork(const char* filename, size_type size, size_type ndims, const Shard& shard,
+        const SkylineOptions& options, std::FILE* out) {
+    auto dataset = shardRead<T>(filename, size, ndims, shard);
+    Skyline skyline;
+    SkylineStats stats;
+    skylineCompute(dataset, options, skyline, stats);
+
+    std::uint64_t header[3] = {skyline.size(), stats.comparisonCount, stats.oracleCalls};
+    shardWriteBytes(out, header, sizeof(header));
+    for (auto i : skyline) {
+        std::uint64_t index = shard.first + i;
+        shardWriteBytes(out, &index, sizeof(index));
+        shardWriteBytes(out, &dataset(i,0), ndims * sizeof(T));
+    }
+    if (std::fflush(out) != 0) {
+        throw std::runtime_error(std::string("cannot write shard result: ") + std::strerror(errno));
+    }
+}
+
+template<typename T>
+void shardedSkyline(size_type size, size_type ndims, size_type workers, const std::vector<std::string>& workerCommand,
+        const SkylineOptions& options, Skyline& skyline, SkylineStats& stats) {
+    if (workers == 0) {
+        throw std::runtime_error("Number of workers must be positive");
+    }
+    auto shards = shardSplit(size, workers);
+    // All workers are started before any result is read, so that they run concurrently.
+    std::vector<std::unique_ptr<ChildProcess>> processes;
+    for (size_type s = 0; s < shards.size(); s++) {
+        auto command = workerCommand;
+        command.push_back(std::to_string(s));
+        command.push_back(std::to_string(shards.size()));
+        command.push_back(std::to_string(shards[s].first));
+        command.push_back(std::to_string(shards[s].count));
+        processes.emplace_back(new ChildProcess(command));
+        processes.back()->closeInput();
+    }
+
+    // Union of the local skylines: global indices, and a contiguous copy of the values.
+    Skyline indices;
+    std::vector<T> rows;
+    stats.comparisonCount = 0;
+    stats.oracleCalls = 0;
+    for (size_type s = 0; s < processes.size(); s++) {
+        try {
+            auto name = "result of worker " + std::to_string(s);
+            FileHandle f(fdopen(dup(processes[s]->output()), "rb"), &std::fclose);
+            if (!f) {
+                throw std::runtime_error("cannot read " + name + ": " + std::strerror(errno));
+            }
+            std::uint64_t header[3];
+            shardReadBytes(f.get(), header, sizeof(header), name);
+            if (header[0] > shards[s].count) {
+                throw std::runtime_error("malformed " + name);
+            }
+            stats.comparisonCount += header[1];
+            stats.oracleCalls += header[2];
+            for (std::uint64_t r = 0; r < header[0]; r++) {
+                std::uint64_t index;
+                shardReadBytes(f.get(), &index, sizeof(index), name);
+                if (index < shards[s].first || index - shards[s].first >= shards[s].count) {
+                    throw std::runtime_error("malformed " + name);
+                }
+                indices.push_back(index);
+                rows.resize(rows.size() + ndims);
+                shardReadBytes(f.get(), &rows[rows.size() - ndims], ndims * sizeof(T), name);
+            }
+        } catch (const std::runtime_error&) {
+            // A worker that failed wrote its error to the standard error, and the result is just truncated.
+            if (!processes[s]->wait()) {
+                throw std::runtime_error("worker " + std::to_string(s) + " failed");
+            }
+            throw;
+        }
+        if (!processes[s]->wait()) {
+            throw std::runtime_error("worker " + std::to_string(s) + " failed");
+        }
+    }
+
+    BasicDataset<T> candidates(indices.size(), ndims);
+    std::copy(rows.begin(), rows.end(), candidates.data());
+    auto mergeOptions = shardOptions(options, shards.size(), shards.size());
+    mergeOptions.threadPool = options.threadPool;
+    Skyline local;
+    SkylineStats mergeStats;
+    // The noisy algorithm needs at least one item; there are candidates unless the dataset is empty.
+    if (!indices.empty()) {
+        skylineCompute(candidates, mergeOptions, local, mergeStats);
+    }
+    stats.comparisonCount += mergeStats.comparisonCount;
+    stats.oracleCalls += mergeStats.oracleCalls;
+
+    skyline.clear();
+    for (auto r : local) {
+        skyline.push_back(indices[r]);
+    }
+    std::sort(skyline.begin(), skyline.end());
+}
+
+#define SHARD_INSTANTIATE(T) \
+    template BasicDataset<T> shardRead<T>(const char*, size_type, size_type, const Shard&); \
+    template void shardWork<T>(const char*, size_type, size_type, const Shard&, const SkylineOptions&, std::FILE*); \
+    template void shardedSkyline<T>(size_type, size_type, size_type, const std::vector<std::string>&, \
+            const SkylineOptions&, Skyline&, SkylineStats&);
+SKYLINE_VALUE_TYPES(SHARD_INSTANTIATE)
+#undef SHARD_INSTANTIATE
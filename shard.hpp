@@ -0,0 +1,77 @@
+#ifndef SHARD_HPP_
+#define SHARD_HPP_
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+#include "skyline.hpp"
+
+/*
+ * Skyline of a dataset file computed by worker processes, each of which reads a contiguous shard of the file
+ * and computes its local skyline with skylineCompute(); the coordinator merges the local skylines
+ * by computing the skyline of their union, which is the skyline of the whole dataset.
+ *
+ * Workers are local processes that send their results through pipes,
+ * in a format that does not depend on the transport:
+ * three 64-bit numbers (number of items, comparisons and oracle calls),
+ * followed by a record of every item of the local skyline: its 64-bit global index followed by its values.
+ * The coordinator needs only the results, not the dataset file.
+ *
+ * Templates are instantiated for every type of values in SKYLINE_VALUE_TYPES.
+ */
+
+/** Contiguous range of items of a dataset file, processed by one worker. */
+struct Shard {
+    size_type first;
+    size_type count;
+};
+
+/**
+ * Split size items into at most count contiguous shards of almost equal sizes;
+ * there are fewer shards if count > size, so that no shard is empty.
+ */
+std::vector<Shard> shardSplit(size_type size, size_type count);
+
+/**
+ * Options for one of the shards, or for the merge if shard == shards.
+ * The noisy algorithm gets an equal share of the tolerance for every shard and for the merge,
+ * so by the union bound the result is wrong with probability at most the tolerance;
+ * every share gets its own seed. Shards are computed in the calling thread of the worker.
+ */
+SkylineOptions shardOptions(const SkylineOptions& options, size_type shards, size_type shard);
+
+/**
+ * Read the items of the shard from binary dataset file in row-major format,
+ * that is, only the byte range that holds them.
+ *
+ * @throws std::runtime_error if the file cannot be read, or does not hold exactly size * ndims values.
+ */
+template<typename T>
+BasicDataset<T> shardRead(const char* filename, size_type size, size_type ndims, const Shard& shard);
+
+/**
+ * Compute the local skyline of the shard, and write it in the format of worker results.
+ *
+ * @throws std::runtime_error if the file cannot be read, or the result cannot be written.
+ */
+template<typename T>
+void shardWork(const char* filename, size_type size, size_type ndims, const Shard& shard,
+        const SkylineOptions& options, std::FILE* out);
+
+/**
+ * Compute the skyline of the dataset file with at most the specified number of worker processes,
+ * one for every shard of shardSplit(), sorted by item index;
+ * the comparison and oracle call counts of stats are the totals of the workers and the merge.
+ * Every worker is started with workerCommand followed by
+ * the index of its shard, the number of shards, and the first item and the number of items of the shard,
+ * and must call shardWork() with shardOptions() of its shard.
+ *
+ * @throws std::runtime_error if a worker cannot be started, fails, or sends a malformed result.
+ */
+template<typename T>
+void shardedSkyline(size_type size, size_type ndims, size_type workers, const std::vector<std::string>& workerCommand,
+        const SkylineOptions& options, Skyline& skyline, SkylineStats& stats);
+
+#endif // SHARD_HPP_
@@ -0,0 +1,124 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "shard.hpp"
+#include "skyline.hpp"
+
+/*
+ * Sharded skyline: the coordinator starts this executable again, with --worker as the first argument,
+ * once for every shard, and merges the local skylines that the workers write to their standard output.
+ * Arguments of a worker: --worker type algorithm tolerance error_probability seed mode input size dimensions,
+ * followed by the arguments appended by shardedSkyline().
+ */
+
+/** Number of arguments of a worker, including the name of the executable. */
+static const int WORKER_ARGC = 15;
+
+/** Compute the local skyline of a shard, as a worker; values have type T. */
+template<typename T>
+static void work(char** argv, const SkylineOptions& options) {
+    auto size = datasetSizeParse(argv[9]);
+    auto dimensions = datasetSizeParse(argv[10]);
+    auto shards = datasetSizeParse(argv[12]);
+    Shard shard = {datasetSizeParse(argv[13]), datasetSizeParse(argv[14])};
+    shardWork<T>(argv[8], size, dimensions, shard, shardOptions(options, shards, datasetSizeParse(argv[11])), stdout);
+}
+
+/** Run the function template F with values of the type named by the string. */
+#define SHARD_DISPATCH(type, F, ...) \
+    switch (valueTypeParse(type)) { \
+        case ValueType::float64: F<double>(__VA_ARGS__); break; \
+        case ValueType::float32: F<float>(__VA_ARGS__); break; \
+        case ValueType::int32: F<std::int32_t>(__VA_ARGS__); break; \
+        case ValueType::uint16: F<std::uint16_t>(__VA_ARGS__); break; \
+    }
+
+/** Parse the options that are passed to the workers. */
+static SkylineOptions optionsParse(const char* algorithm, const char* tolerance, const char* errorProbability,
+        const char* seed, const char* mode) {
+    SkylineOptions options;
+    options.algorithm = algorithmParse(algorithm);
+    options.tolerance = std::stod(tolerance);
+    options.errorProbability = std::stod(errorProbability);
+    options.seed = std::stoull(seed);
+    if (std::strcmp(mode, "sequential") == 0) {
+        options.comparisonMode = ComparisonMode::sequential;
+    } else if (std::strcmp(mode, "majority") != 0) {
+        throw std::runtime_error(std::string("Unknown comparison mode: ") + mode);
+    }
+    return options;
+}
+
+/** Main entry point. */
+int main(int argc, char** argv) {
+    if (argc >= 2 && std::strcmp(argv[1], "--worker") == 0) {
+        if (argc != WORKER_ARGC) {
+            std::cerr << "Invalid worker arguments" << std::endl;
+            return EXIT_FAILURE;
+        }
+        try {
+            auto options = optionsParse(argv[3], argv[4], argv[5], argv[6], argv[7]);
+            SHARD_DISPATCH(argv[2], work, argv, options)
+            return EXIT_SUCCESS;
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    const char* type = "double";
+    if (argc >= 3 && std::strcmp(argv[argc - 2], "--type") == 0) {
+        type = argv[argc - 1];
+        argc -= 2;
+    }
+    if (argc < 6 || argc > 11 || argc == 8) {
+        std::cerr << "Usage: " << argv[0] << " input output size dimensions workers"
+                << " [algorithm [tolerance error_probability [seed [majority|sequential]]]]"
+                << " [--type double|float|int32|uint16]" << std::endl;
+        std::cerr << "The merge runs in the calling process; the noisy algorithm splits the tolerance"
+                << " equally between the shards and the merge." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto input = argv[1];
+    auto output = argv[2];
+    auto size = datasetSizeParse(argv[3]);
+    auto dimensions = datasetSizeParse(argv[4]);
+    auto workers = datasetSizeParse(argv[5]);
+
+    try {
+        std::string algorithm = (argc >= 7) ? argv[6] : "bnl";
+        std::string tolerance = (argc >= 9) ? argv[7] : "0.1";
+        std::string errorProbability = (argc >= 9) ? argv[8] : "0";
+        std::string seed = (argc >= 10) ? argv[9] : std::to_string(std::random_device()());
+        std::string mode = (argc >= 11) ? argv[10] : "majority";
+        auto options = optionsParse(algorithm.c_str(), tolerance.c_str(), errorProbability.c_str(), seed.c_str(),
+                mode.c_str());
+
+        // Between fork and exec, /proc/self/exe of the child is still this executable.
+        std::vector<std::string> workerCommand = {"/proc/self/exe", "--worker", type, algorithm, tolerance,
+                errorProbability, seed, mode, input, argv[3], argv[4]};
+
+        Skyline skyline;
+        SkylineStats stats;
+        auto beforeTime = std::chrono::steady_clock::now();
+        SHARD_DISPATCH(type, shardedSkyline, size, dimensions, workers, workerCommand, options, skyline, stats)
+        auto afterTime = std::chrono::steady_clock::now();
+
+        skylineWrite(skyline, output);
+
+        auto runningTime = std::chrono::duration_cast<std::chrono::milliseconds>(afterTime - beforeTime).count();
+        std::cout << runningTime << " " << stats.comparisonCount << " " << stats.oracleCalls << std::endl;
+        return EXIT_SUCCESS;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,104 @@
+#include "skyline.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "bskytree.hpp"
+#include "nestedloops.hpp"
+#include "noisless.hpp"
+
+Algorithm algorithmParse(const char* s) {
+    if (std::strcmp(s, "nestedloops") == 0) {
+        return Algorithm::nestedloops;
+    } else if (std::strcmp(s, "columnar") == 0) {
+        return Algorithm::columnar;
+    } else if (std::strcmp(s, "bnl") == 0) {
+        return Algorithm::bnl;
+    } else if (std::strcmp(s, "sfs") == 0) {
+        return Algorithm::sfs;
+    } else if (std::strcmp(s, "noisless") == 0) {
+        return Algorithm::noisless;
+    } else if (std::strcmp(s, "bskytree") == 0) {
+        return Algorithm::bskytree;
+    } else if (std::strcmp(s, "noisy") == 0) {
+        return Algorithm::noisy;
+    }
+    throw std::runtime_error(std::string("Unknown algorithm: ") + s);
+}
+
+SkylineOptions::SkylineOptions()
+        : algorithm(Algorithm::nestedloops), threadPool(nullptr),
+          tolerance(0.1), errorProbability(0.0), seed(0), comparisonMode(ComparisonMode::majority), sortedIndex(false),
+          reusePrefix(false) {
+}
+
+SkylineStats::SkylineStats()
+        : comparisonCount(0), oracleCalls(0) {
+}
+
+/** Compute the skyline with the noisy algorithm. */
+static void skylineNoisy(const Dataset& dataset, const SkylineOptions& options, Skyline& skyline,
+        SkylineStats& stats) {
+    NoisyOptions noisyOptions;
+    noisyOptions.comparisonMode = options.comparisonMode;
+    noisyOptions.threadPool = options.threadPool;
+    noisyOptions.sortedIndex = options.sortedIndex;
+    noisyOptions.reusePrefix = options.reusePrefix;
+    Oracle oracle = options.judge ? Oracle(options.judge) : Oracle(dataset, options.errorProbability, options.seed);
+    noisy(oracle, options.tolerance, noisyOptions, stats.noisy, skyline);
+    stats.comparisonCount = stats.noisy.comparisonCount;
+    stats.oracleCalls = oracle.comparisonCount();
+}
+
+/** The oracle emulates noisy comparisons of value_type values only. */
+template<typename T>
+static void skylineNoisy(const BasicDataset<T>&, const SkylineOptions&, Skyline&, SkylineStats&) {
+    throw std::invalid_argument("Noisy algorithm requires values of type double");
+}
+
+template<typename T>
+void skylineCompute(const BasicDataset<T>& dataset, const SkylineOptions& options, Skyline& skyline,
+        SkylineStats& stats) {
+    switch (options.algorithm) {
+        case Algorithm::nestedloops: {
+            nestedloops(dataset, skyline, stats.comparisonCount);
+            break;
+        }
+        case Algorithm::columnar: {
+            nestedloopsColumnar(dataset, skyline, stats.comparisonCount);
+            break;
+        }
+        case Algorithm::bnl: {
+            bnl(dataset, skyline, stats.comparisonCount);
+            break;
+        }
+        case Algorithm::sfs: {
+            sfs(dataset, skyline, stats.comparisonCount);
+            break;
+        }
+        case Algorithm::noisless: {
+            if (options.threadPool != nullptr) {
+                noislessParallel(dataset, *options.threadPool, skyline, stats.comparisonCount);
+            } else {
+                noisless(dataset, skyline, stats.comparisonCount);
+            }
+            break;
+        }
+        case Algorithm::bskytree: {
+            bskytree(dataset, skyline, stats.comparisonCount);
+            break;
+        }
+        case Algorithm::noisy: {
+            skylineNoisy(dataset, options, skyline, stats);
+            break;
+        }
+    }
+    std::sort(skyline.begin(), skyline.end());
+}
+
+#define SKYLINE_INSTANTIATE(T) \
+    template void skylineCompute<T>(const BasicDataset<T>&, const SkylineOptions&, Skyline&, SkylineStats&);
+SKYLINE_VALUE_TYPES(SKYLINE_INSTANTIATE)
+#undef SKYLINE_INSTANTIATE
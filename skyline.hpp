@@ -0,0 +1,94 @@
+#ifndef SKYLINE_HPP_
+#define SKYLINE_HPP_
+
+#include <cstdint>
+#include <memory>
+
+#include "common.hpp"
+#include "judge.hpp"
+#include "noisy.hpp"
+#include "threadpool.hpp"
+
+/** Skyline algorithms of the library. */
+enum class Algorithm {
+    /** Simple nested loops. */
+    nestedloops,
+    /** Simple nested loops over a column-major copy of the dataset. */
+    columnar,
+    /** Block-nested-loops. */
+    bnl,
+    /** Sort-filter-skyline. */
+    sfs,
+    /** Output-sensitive algorithm; parallel divide and conquer if a thread pool is given. */
+    noisless,
+    /** Recursive partitioning around pivot items; always in the calling thread. */
+    bskytree,
+    /** Output-sensitive algorithm with noisy comparisons, using the oracle emulated over the dataset. */
+    noisy,
+};
+
+/**
+ * Convert string ("nestedloops", "columnar", "bnl", "sfs", "noisless", "bskytree" or "noisy") to algorithm.
+ *
+ * @throws std::runtime_error if the string is not a name of an algorithm.
+ */
+Algorithm algorithmParse(const char* s);
+
+/** Options of skylineCompute(). */
+struct SkylineOptions {
+    /** Default options: nested loops in the calling thread. */
+    SkylineOptions();
+
+    Algorithm algorithm;
+    /**
+     * Pool for the parallel algorithms, or nullptr to compute the skyline in the calling thread;
+     * one pool may be shared by concurrent computations.
+     */
+    ThreadPool* threadPool;
+
+    /*
+     * Options of the noisy algorithm.
+     */
+
+    /** Probability that the computed skyline is wrong. */
+    double tolerance;
+    /** Probability that the emulated oracle gives the wrong answer to a query. */
+    double errorProbability;
+    /** Seed of the oracle errors. */
+    std::uint64_t seed;
+    ComparisonMode comparisonMode;
+    bool sortedIndex;
+    bool reusePrefix;
+    /**
+     * Judge that answers the queries instead of the oracle emulated over the dataset, or nullptr;
+     * its error probability replaces errorProbability, and the seed is not used.
+     */
+    std::shared_ptr<Judge> judge;
+};
+
+/** Statistics of one call of skylineCompute(). */
+struct SkylineStats {
+    SkylineStats();
+
+    /** Number of comparisons of values, or of calls to less() for the noisy algorithm. */
+    size_type comparisonCount;
+    /** Number of queries to the oracle; only for the noisy algorithm. */
+    size_type oracleCalls;
+    /** Detailed statistics of the noisy algorithm. */
+    NoisyStats noisy;
+};
+
+/**
+ * Compute the skyline of the dataset, sorted by item index;
+ * instantiated for every type of values in SKYLINE_VALUE_TYPES.
+ *
+ * Reentrant and thread-safe: the dataset and the options may be shared by concurrent calls,
+ * which must use separate results and statistics.
+ *
+ * @throws std::invalid_argument if the noisy algorithm is requested for values other than value_type.
+ */
+template<typename T>
+void skylineCompute(const BasicDataset<T>& dataset, const SkylineOptions& options, Skyline& skyline,
+        SkylineStats& stats);
+
+#endif // SKYLINE_HPP_
@@ -0,0 +1,74 @@
+#ifndef STATS_HPP_
+#define STATS_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * Counters of one instrumented phase of a computation; updated concurrently.
+ *
+ * Phases are measured inclusively: the time and the queries of nested phases
+ * are also added to the enclosing ones, and the time is summed over all threads that run the phase.
+ */
+struct PhaseStats {
+    constexpr PhaseStats()
+            : calls(0), queries(0), nanoseconds(0) {
+    }
+
+    void reset() {
+        calls = 0;
+        queries = 0;
+        nanoseconds = 0;
+    }
+
+    /** Number of times the phase was entered. */
+    std::atomic<std::uint64_t> calls;
+    /** Number of queries made to the source while in the phase. */
+    std::atomic<std::uint64_t> queries;
+    /** Total time spent in the phase. */
+    std::atomic<std::uint64_t> nanoseconds;
+};
+
+/**
+ * Adds one call, the running time and the increase of source.comparisonCount()
+ * during the lifetime of the scope to the phase statistics.
+ * The source must be used only by the current thread while the scope is alive.
+ */
+template<typename Source>
+class PhaseScope {
+public:
+    PhaseScope(PhaseStats& stats, const Source& source)
+            : stats_(stats), source_(source), queries_(source.comparisonCount()),
+              start_(std::chrono::steady_clock::now()) {
+    }
+
+    ~PhaseScope() {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        stats_.calls++;
+        stats_.queries += source_.comparisonCount() - queries_;
+        stats_.nanoseconds += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+    PhaseScope(const PhaseScope&) = delete;
+    PhaseScope& operator=(const PhaseScope&) = delete;
+
+private:
+    PhaseStats& stats_;
+    const Source& source_;
+    const std::uint64_t queries_;
+    const std::chrono::steady_clock::time_point start_;
+};
+
+/*
+ * Measure the rest of the enclosing block as a phase;
+ * expands to nothing unless the statistics are enabled with the SKYLINE_STATS definition.
+ */
+#ifdef SKYLINE_STATS
+#define PHASE_SCOPE(stats, source) PhaseScope<std::remove_reference<decltype(source)>::type> phaseScope((stats), (source))
+#else
+#define PHASE_SCOPE(stats, source) static_cast<void>(0)
+#endif
+
+#endif // STATS_HPP_
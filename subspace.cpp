@@ -0,0 +1,221 @@
+#include "subspace.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+#include "bskytree.hpp"
+
+Subspace subspaceParse(const std::string& s, size_type ndims) {
+    Subspace subspace = 0;
+    size_type position = 0;
+    while (position < s.size()) {
+        auto c = s[position];
+        if (c == '+' || c == ',' || std::isspace(static_cast<unsigned char>(c))) {
+            position++;
+            continue;
+        }
+        if (!std::isdigit(static_cast<unsigned char>(c))) {
+            throw std::invalid_argument("Invalid subspace: " + s);
+        }
+        size_type dim = 0;
+        for (; position < s.size() && std::isdigit(static_cast<unsigned char>(s[position])); position++) {
+            dim = std::min(10 * dim + static_cast<size_type>(s[position] - '0'), ndims);
+        }
+        if (dim >= ndims || dim >= SUBSPACE_MAX_DIMS) {
+            throw std::invalid_argument("Dimension out of range in subspace: " + s);
+        }
+        subspace |= Subspace(1) << dim;
+    }
+    if (subspace == 0) {
+        throw std::invalid_argument("Empty subspace");
+    }
+    return subspace;
+}
+
+template<typename T>
+SubspaceSkylines<T>::SubspaceSkylines(const BasicDataset<T>& dataset, size_type capacity)
+        : dataset_(dataset), capacity_(capacity), distinctCount_(dataset.ndims(), 0), order_(dataset.ndims()),
+          cachedItems_(0), clock_(0), hitCount_(0), sharedCount_(0), missCount_(0), comparisonCount_(0) {
+    if (dataset.ndims() > SUBSPACE_MAX_DIMS) {
+        throw std::invalid_argument("Subspace queries support at most " + std::to_string(SUBSPACE_MAX_DIMS)
+                + " dimensions");
+    }
+    std::vector<std::pair<T, size_type>> column(dataset.size());
+    for (size_type k = 0; k < dataset.ndims(); k++) {
+        for (size_type i = 0; i < dataset.size(); i++) {
+            column[i] = {dataset(i,k), i};
+        }
+        std::sort(column.begin(), column.end());
+        for (size_type r = 0; r < column.size(); r++) {
+            if (r == 0 || column[r - 1].first < column[r].first) {
+                distinctCount_[k]++;
+            }
+        }
+        // Ties are never looked up along a dimension with distinct values.
+        if (distinctCount_[k] < dataset.size()) {
+            order_[k].reserve(dataset.size());
+            for (const auto& value : column) {
+                order_[k].push_back(value.second);
+            }
+        }
+    }
+}
+
+template<typename T>
+const Skyline& SubspaceSkylines<T>::query(Subspace subspace) {
+    if (subspace == 0 || (dataset_.ndims() < SUBSPACE_MAX_DIMS && (subspace >> dataset_.ndims()) != 0)) {
+        throw std::invalid_argument("Subspace out of range");
+    }
+    clock_++;
+    auto found = cache_.find(subspace);
+    if (found != cache_.end()) {
+        found->second.lastUse = clock_;
+        hitCount_++;
+        return found->second.skyline;
+    }
+
+    const Skyline* superspace = nullptr;
+    for (const auto& entry : cache_) {
+        if ((subspace & ~entry.first) == 0
+                && (superspace == nullptr || entry.second.skyline.size() < superspace->size())) {
+            superspace = &entry.second.skyline;
+        }
+    }
+    Skyline items;
+    if (superspace != nullptr) {
+        candidates(subspace, *superspace, items);
+        sharedCount_++;
+    } else {
+        items.resize(dataset_.size());
+        std::iota(items.begin(), items.end(), 0);
+        missCount_++;
+    }
+
+    // The skyline is computed over a contiguous projection of the candidates on the subspace.
+    std::vector<size_type> dims;
+    for (size_type k = 0; k < dataset_.ndims(); k++) {
+        if ((subspace >> k) & 1) {
+            dims.push_back(k);
+        }
+    }
+    BasicDataset<T> projection(items.size(), dims.size());
+    for (size_type r = 0; r < items.size(); r++) {
+        for (size_type c = 0; c < dims.size(); c++) {
+            projection(r,c) = dataset_(items[r], dims[c]);
+        }
+    }
+    Skyline local;
+    size_type comparisons = 0;
+    bskytree(projection, local, comparisons);
+    comparisonCount_ += comparisons;
+
+    auto& entry = cache_[subspace];
+    entry.lastUse = clock_;
+    entry.skyline.reserve(local.size());
+    for (auto r : local) {
+        entry.skyline.push_back(items[r]);
+    }
+    std::sort(entry.skyline.begin(), entry.skyline.end());
+    cachedItems_ += entry.skyline.size();
+    evict(subspace);
+    return entry.skyline;
+}
+
+template<typename T>
+void SubspaceSkylines<T>::candidates(Subspace subspace, const Skyline& superspace, Skyline& items) {
+    // The dimension with the most distinct values goes first, since the ties are looked up along it.
+    std::vector<size_type> dims;
+    for (size_type k = 0; k < dataset_.ndims(); k++) {
+        if ((subspace >> k) & 1) {
+            dims.push_back(k);
+            if (distinctCount_[k] > distinctCount_[dims.front()]) {
+                std::swap(dims.front(), dims.back());
+            }
+        }
+    }
+    auto first = dims.front();
+    if (distinctCount_[first] == dataset_.size()) {
+        items = superspace;
+        return;
+    }
+
+    auto less = [&](size_type i, size_type j) {
+        for (auto k : dims) {
+            if (dataset_(i,k) < dataset_(j,k)) {
+                return true;
+            }
+            if (dataset_(j,k) < dataset_(i,k)) {
+                return false;
+            }
+        }
+        return false;
+    };
+    Skyline sorted(superspace);
+    std::sort(sorted.begin(), sorted.end(), less);
+
+    // Only the items equal to a skyline item on the first dimension are looked up among the skyline items
+    // with the same value, so every item is looked up at most once.
+    const auto& column = order_[first];
+    items.clear();
+    for (auto group = sorted.begin(); group != sorted.end();) {
+        auto value = dataset_(*group, first);
+        auto groupEnd = std::find_if(group, sorted.end(), [&](size_type j) {
+            return value < dataset_(j, first);
+        });
+        auto tied = std::lower_bound(column.begin(), column.end(), value, [&](size_type i, T v) {
+            return dataset_(i, first) < v;
+        });
+        for (; tied != column.end() && !(value < dataset_(*tied, first)); ++tied) {
+            if (std::binary_search(group, groupEnd, *tied, less)) {
+                items.push_back(*tied);
+            }
+        }
+        group = groupEnd;
+    }
+    std::sort(items.begin(), items.end());
+}
+
+template<typename T>
+void SubspaceSkylines<T>::evict(Subspace subspace) {
+    while (cachedItems_ > capacity_) {
+        auto victim = cache_.end();
+        for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+            if (it->first != subspace && (victim == cache_.end() || it->second.lastUse < victim->second.lastUse)) {
+                victim = it;
+            }
+        }
+        if (victim == cache_.end()) {
+            break;
+        }
+        cachedItems_ -= victim->second.skyline.size();
+        cache_.erase(victim);
+    }
+}
+
+template<typename T>
+size_type SubspaceSkylines<T>::hitCount() const {
+    return hitCount_;
+}
+
+template<typename T>
+size_type SubspaceSkylines<T>::sharedCount() const {
+    return sharedCount_;
+}
+
+template<typename T>
+size_type SubspaceSkylines<T>::missCount() const {
+    return missCount_;
+}
+
+template<typename T>
+size_type SubspaceSkylines<T>::comparisonCount() const {
+    return comparisonCount_;
+}
+
+#define SUBSPACE_INSTANTIATE(T) \
+    template class SubspaceSkylines<T>;
+SKYLINE_VALUE_TYPES(SUBSPACE_INSTANTIATE)
+#undef SUBSPACE_INSTANTIATE
@@ -0,0 +1,97 @@
+#ifndef SUBSPACE_HPP_
+#define SUBSPACE_HPP_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "common.hpp"
+
+/** Set of dimensions: bit k is set if dimension k belongs to the subspace. */
+using Subspace = std::uint64_t;
+
+/** Maximal number of dimensions of datasets with subspace queries. */
+const size_type SUBSPACE_MAX_DIMS = 64;
+
+/**
+ * Convert string of dimension indices separated by '+', ',' or spaces (e.g. "0+2") to subspace.
+ *
+ * @throws std::invalid_argument if the string is empty, or has something other than indices below ndims.
+ */
+Subspace subspaceParse(const std::string& s, size_type ndims);
+
+/**
+ * Skylines of subspaces of a resident dataset, with the results cached and shared between related subspaces
+ * (Pei et al. "Computing Compressed Multidimensional Skyline Cubes Efficiently", ICDE '07).
+ *
+ * Item p in the skyline of subspace U is either in the skyline of any superspace V,
+ * or is equal on U to some item of the skyline of V that dominates it on V.
+ * So the skyline of U is computed by bskytree() over the skyline of the smallest cached superspace,
+ * extended by the items tied with it on U; if some dimension of U has distinct values, there are no ties.
+ * Otherwise, the ties are found through the items sorted along the dimension of U with the most distinct values:
+ * only the items equal to a skyline item on that dimension are compared on the other dimensions of U.
+ * This costs one index of the items for every dimension with repeated values, kept for the lifetime of the cache.
+ * Without a cached superspace, the skyline is computed over the whole dataset.
+ * The least recently used skylines are evicted when the cache holds more than capacity skyline items in total.
+ *
+ * Instantiated for every type of values in SKYLINE_VALUE_TYPES.
+ */
+template<typename T>
+class SubspaceSkylines {
+public:
+    /**
+     * Construct the empty cache; the dataset storage is shared, and must not change afterwards.
+     *
+     * @throws std::invalid_argument if the dataset has more than SUBSPACE_MAX_DIMS dimensions.
+     */
+    SubspaceSkylines(const BasicDataset<T>& dataset, size_type capacity);
+
+    /**
+     * Skyline of the subspace, sorted by item index;
+     * the reference is valid until the next query.
+     *
+     * @throws std::invalid_argument if the subspace is empty or has dimensions out of range.
+     */
+    const Skyline& query(Subspace subspace);
+
+    /** Number of queries answered from the cache. */
+    size_type hitCount() const;
+
+    /** Number of queries computed from a cached superspace. */
+    size_type sharedCount() const;
+
+    /** Number of queries computed from the whole dataset. */
+    size_type missCount() const;
+
+    /** Total number of comparisons of values made by all queries. */
+    size_type comparisonCount() const;
+
+private:
+    struct Entry {
+        Skyline skyline;
+        size_type lastUse;
+    };
+
+    /** Items that may be in the skyline of the subspace, given the skyline of its superspace. */
+    void candidates(Subspace subspace, const Skyline& superspace, Skyline& items);
+
+    /** Evict the least recently used skylines, other than the one of the subspace, until within capacity. */
+    void evict(Subspace subspace);
+
+    const BasicDataset<T> dataset_;
+    const size_type capacity_;
+    /** Number of distinct values of each dimension. */
+    std::vector<size_type> distinctCount_;
+    /** Items sorted by their value on each dimension; empty for dimensions with distinct values. */
+    std::vector<std::vector<size_type>> order_;
+    std::map<Subspace, Entry> cache_;
+    size_type cachedItems_;
+    size_type clock_;
+    size_type hitCount_;
+    size_type sharedCount_;
+    size_type missCount_;
+    size_type comparisonCount_;
+};
+
+#endif // SUBSPACE_HPP_
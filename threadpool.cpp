@@ -0,0 +1,165 @@
+#include "threadpool.hpp"
+
+#include <algorithm>
+#include <exception>
+
+/** Pool that the current thread belongs to, if any. */
+static thread_local const ThreadPool* currentPool = nullptr;
+
+/** Queue of the current thread in currentPool. */
+static thread_local size_type currentQueue = 0;
+
+/** State of one parallelFor() call, shared by its tasks. */
+struct ThreadPool::Loop {
+    Loop(const std::function<void(size_type)>& loopBody, size_type taskCount)
+            : body(loopBody), remaining(taskCount) {}
+
+    const std::function<void(size_type)>& body;
+    std::atomic<size_type> remaining;
+    std::exception_ptr error;
+    std::mutex errorMutex;
+};
+
+ThreadPool::ThreadPool(size_type threads)
+        : queued_(0), stopping_(false) {
+    if (threads == 0) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    // Queue 0 belongs to the threads that submit tasks from outside of the pool.
+    // Every queue has room for the tasks of a parallel loop started by every thread at once.
+    for (size_type i = 0; i < threads; i++) {
+        queues_.emplace_back(new Queue());
+        queues_.back()->tasks.resize(8 * threads);
+        queues_.back()->head = 0;
+        queues_.back()->count = 0;
+    }
+    for (size_type i = 1; i < threads; i++) {
+        workers_.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_type ThreadPool::size() const {
+    return queues_.size();
+}
+
+void ThreadPool::parallelFor(size_type begin, size_type end, const std::function<void(size_type)>& body) {
+    if (begin >= end) {
+        return;
+    }
+    if (size() == 1) {
+        for (size_type i = begin; i < end; i++) {
+            body(i);
+        }
+        return;
+    }
+
+    size_type self = (currentPool == this) ? currentQueue : 0;
+    size_type taskCount = std::min(end - begin, 8 * size());
+    size_type chunk = (end - begin + taskCount - 1) / taskCount;
+    taskCount = (end - begin + chunk - 1) / chunk;
+
+    // Tasks refer to the loop on this stack frame; it outlives them, since all of them are awaited.
+    Loop loop(body, taskCount);
+    for (size_type t = 0; t < taskCount; t++) {
+        auto first = begin + t * chunk;
+        push((self + t) % size(), {&loop, first, std::min(first + chunk, end)});
+    }
+
+    while (loop.remaining > 0) {
+        if (!runTask(self)) {
+            std::this_thread::yield();
+        }
+    }
+    if (loop.error) {
+        std::rethrow_exception(loop.error);
+    }
+}
+
+void ThreadPool::push(size_type queue, const Task& task) {
+    {
+        auto& q = *queues_[queue];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.count == q.tasks.size()) {
+            std::vector<Task> tasks(2 * q.tasks.size());
+            for (size_type i = 0; i < q.count; i++) {
+                tasks[i] = q.tasks[(q.head + i) % q.tasks.size()];
+            }
+            q.tasks.swap(tasks);
+            q.head = 0;
+        }
+        q.tasks[(q.head + q.count) % q.tasks.size()] = task;
+        q.count++;
+    }
+    queued_++;
+    // Taking the lock orders this push before the predicate check of any worker that is about to sleep.
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+    }
+    wakeup_.notify_one();
+}
+
+void ThreadPool::run(const Task& task) {
+    auto& loop = *task.loop;
+    try {
+        for (size_type i = task.first; i < task.last; i++) {
+            loop.body(i);
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(loop.errorMutex);
+        loop.error = std::current_exception();
+    }
+    // The loop may be gone as soon as the last task is counted.
+    loop.remaining--;
+}
+
+bool ThreadPool::runTask(size_type queue) {
+    Task task = {nullptr, 0, 0};
+    bool found = false;
+    for (size_type i = 0; i < size() && !found; i++) {
+        auto& victim = *queues_[(queue + i) % size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.count == 0) {
+            continue;
+        }
+        if (i == 0) {
+            task = victim.tasks[victim.head];
+            victim.head = (victim.head + 1) % victim.tasks.size();
+        } else {
+            task = victim.tasks[(victim.head + victim.count - 1) % victim.tasks.size()];
+        }
+        victim.count--;
+        found = true;
+    }
+    if (!found) {
+        return false;
+    }
+    queued_--;
+    run(task);
+    return true;
+}
+
+void ThreadPool::work(size_type queue) {
+    currentPool = this;
+    currentQueue = queue;
+    while (true) {
+        if (runTask(queue)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        wakeup_.wait(lock, [this]() { return stopping_ || queued_ > 0; });
+        if (stopping_ && queued_ == 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef THREADPOOL_HPP_
+#define THREADPOOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common.hpp"
+
+/**
+ * Fixed-size pool of threads with per-thread task queues and work stealing.
+ *
+ * A thread takes tasks from the front of its own queue,
+ * and steals them from the back of the other queues when its own queue is empty.
+ * Threads that wait for their tasks to finish run queued tasks in the meantime,
+ * so parallel loops can be nested.
+ * Tasks are fixed-size records in preallocated ring buffers, so parallelFor() does not allocate
+ * unless more tasks are queued at once than ever before, or a call throws.
+ */
+class ThreadPool {
+public:
+    /**
+     * Start the pool.
+     *
+     * @param threads Total number of threads, including the thread that submits tasks;
+     *     0 stands for the number of hardware threads.
+     */
+    explicit ThreadPool(size_type threads);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Total number of threads, including the thread that submits tasks.
+     */
+    size_type size() const;
+
+    /**
+     * Call body(i) for every i in [begin; end), and wait until all calls are finished.
+     * The range is split into several times more tasks than there are threads.
+     * If any call throws, one of the exceptions is rethrown after all tasks are finished.
+     */
+    void parallelFor(size_type begin, size_type end, const std::function<void(size_type)>& body);
+
+private:
+    struct Loop;
+
+    /** Calls of the body of a parallel loop for the indices in [first; last). */
+    struct Task {
+        Loop* loop;
+        size_type first;
+        size_type last;
+    };
+
+    /** Ring buffer of tasks; it grows only when it is full. */
+    struct Queue {
+        std::mutex mutex;
+        std::vector<Task> tasks;
+        size_type head;
+        size_type count;
+    };
+
+    /** Add a task to the specified queue. */
+    void push(size_type queue, const Task& task);
+
+    /** Run the calls of the task, and record its completion in its loop. */
+    static void run(const Task& task);
+
+    /** Run one task from the specified queue, or steal it from the other queues. */
+    bool runTask(size_type queue);
+
+    /** Main loop of the worker thread that owns the specified queue. */
+    void work(size_type queue);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::atomic<size_type> queued_;
+    bool stopping_;
+};
+
+#endif // THREADPOOL_HPP_